@@ -0,0 +1,72 @@
+/**
+ * @file Arena.hpp
+ * @brief 线性分配区模块
+ * @details 按块向系统申请内存，块内顺序分配；对象不单独释放，
+ *          一次编译结束后整体复位
+ */
+
+#ifndef _ARENA_HPP
+#define _ARENA_HPP
+
+#include <Types.hpp>
+using namespace std;
+
+const size_t ARENA_BLOCK_SIZE = 64 * 1024;    // 默认每块字节数
+
+/**
+ * @class Arena
+ * @brief 线性(bump)分配区
+ * @details 分配只移动块内指针；超过块大小的请求单独成块。
+ *          分配出的对象不调用析构函数，只应存放可平凡析构的类型
+ */
+class Arena
+{
+private:
+    vector<char*> blocks;         // 已申请的块
+    char* cursor = nullptr;       // 当前块内下一个可分配位置
+    char* limit = nullptr;        // 当前块结束位置
+    size_t blockSize;             // 每块字节数
+    size_t used = 0;              // 已分配字节数(含对齐填充)
+    size_t reserved = 0;          // 已申请字节数
+    size_t firstSize = 0;         // 第一块字节数(复位后保留)
+
+    void* Grow(size_t bytes, size_t align);  // 申请新块并在其中分配
+
+public:
+    explicit Arena(size_t blockSize = ARENA_BLOCK_SIZE) : blockSize(blockSize) {}
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief 分配一段内存
+     * @param bytes 字节数
+     * @param align 对齐要求(2的幂)
+     * @return 内存起始地址
+     */
+    void* Allocate(size_t bytes, size_t align)
+    {
+        char* p = (char*)(((uintptr_t)cursor + align - 1) & ~(uintptr_t)(align - 1));
+        if (cursor == nullptr || p + bytes > limit) {
+            return Grow(bytes, align);
+        }
+        used += p + bytes - cursor;
+        cursor = p + bytes;
+        return p;
+    }
+
+    /**
+     * @brief 分配并值初始化一个对象
+     */
+    template <typename T>
+    T* New()
+    {
+        return new (Allocate(sizeof(T), alignof(T))) T();
+    }
+
+    void Reset();                                   // 整体复位，只保留第一块
+    size_t GetUsedBytes() { return used; };         // 获取已分配字节数
+    size_t GetReservedBytes() { return reserved; }; // 获取已申请字节数
+};
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file Ast.hpp
+ * @brief 抽象语法树模块
+ * @details 语法树模式下语法分析器不直接生成P-Code，而是在线性分配区中建立紧凑的语法树，
+ *          分析结束后再由降级(lowering)过程生成与直接生成完全相同的P-Code
+ */
+
+#ifndef _AST_HPP
+#define _AST_HPP
+
+#include <Types.hpp>
+#include <Arena.hpp>
+#include <SymTable.hpp>
+#include <PCode.hpp>
+using namespace std;
+
+const int OPR_NONE = -1;    // 关系运算符缺失时的错误恢复: 两侧均求值但不生成比较
+
+/**
+ * @enum AstKind
+ * @brief 语法树节点类别
+ */
+enum AstKind : uint8_t {
+    AST_LIT,        // 常量: L层差，a值
+    AST_LOAD,       // 取变量: L层差，a偏移
+    AST_UNARY,      // 一元运算(取负/odd): op运算，left操作数
+    AST_BINARY,     // 二元运算: op运算，left/right操作数
+    AST_ASSIGN,     // 赋值: left值，有目标时存入(L, a)
+    AST_IF,         // 条件: left条件，right为then分支，other为else分支
+    AST_WHILE,      // 循环: left条件，right循环体
+    AST_ARG,        // 实参: left值，存入新活动记录的a单元
+    AST_CALL,       // 调用: left实参列表，info被调过程，L层差
+    AST_READ,       // 读语句: left为AST_LOAD目标列表
+    AST_PRINT,      // 输出项: left值
+    AST_WRITE,      // 写语句: left输出项列表，结束后换行
+    AST_SEQ,        // 语句序列: left首节点
+    AST_BLOCK,      // 分程序: left过程列表，right复合语句，a分配大小，info回填入口的过程
+    AST_PROC,       // 过程(含主程序): info过程信息，right分程序
+};
+
+/* ====== 节点标志 ====== */
+const uint8_t AST_HAS_TARGET = 0x01;    // 赋值有合法目标 / 调用生成CAL
+const uint8_t AST_HAS_JPC = 0x02;       // 条件语句生成了JPC(出现then或缺then的语句)
+const uint8_t AST_HAS_JMP = 0x04;       // 条件语句生成了JMP(出现else)
+const uint8_t AST_HAS_BODY = 0x08;      // 循环语句有循环体
+const uint8_t AST_HAS_RETURN = 0x10;    // 过程生成了返回指令
+const uint8_t AST_NO_COND = 0x20;       // 循环条件恒真(常量折叠后): 不求值条件、不生成JPC
+
+/**
+ * @struct AstNode
+ * @brief 紧凑的语法树节点
+ * @details 所有类别共用一种48字节的节点，各字段含义见AstKind；
+ *          同一列表中的节点经next相连。错误恢复路径上缺失的部分以空指针表示
+ */
+struct AstNode
+{
+    AstKind kind;             // 节点类别
+    uint8_t flags;            // 节点标志
+    int16_t op;               // 运算类型(OPR_*)
+    int L;                    // 层差
+    int a;                    // 偏移/常量值/分配大小
+    AstNode* next;            // 同一列表中的下一个节点
+    AstNode* left;            // 操作数/条件/子节点列表
+    AstNode* right;           // 右操作数/分支/循环体/分程序
+    union {
+        AstNode* other;       // else分支
+        Information* info;    // 过程信息
+    };
+};
+
+/**
+ * @struct AstList
+ * @brief 建立节点列表时使用的首尾指针
+ */
+struct AstList
+{
+    AstNode* head = nullptr;
+    AstNode** tail = &head;
+
+    void Append(AstNode* node)
+    {
+        if (node) {
+            *tail = node;
+            tail = &node->next;
+        }
+    }
+};
+
+void LowerAst(const AstNode* node, PCodeList& code);   // 由语法树生成P-Code
+size_t CountAstNodes(const AstNode* node);              // 统计语法树节点数
+
+#endif
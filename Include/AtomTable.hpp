@@ -0,0 +1,104 @@
+/**
+ * @file AtomTable.hpp
+ * @brief 标识符原子表模块
+ * @details 为每个不同的标识符分配一个32位原子编号，
+ *          词法分析、语法分析与符号表之间以原子代替字符串传递和比较
+ */
+
+#ifndef _ATOM_TABLE_HPP
+#define _ATOM_TABLE_HPP
+
+#include <Types.hpp>
+using namespace std;
+
+typedef uint32_t Atom;                  // 标识符原子
+const Atom NO_ATOM = 0xFFFFFFFF;        // 无效原子
+const size_t ATOM_INIT_SLOTS = 1024;    // 初始哈希槽数(2的幂)
+
+/**
+ * @class AtomTable
+ * @brief 标识符原子表
+ * @details 名称以UTF-8字节连续存放在一个字节池中，开放定址哈希表按名称查找原子；
+ *          相同名称总是得到相同原子，只有诊断输出与符号表显示时才展宽为宽字符串
+ */
+class AtomTable
+{
+private:
+    vector<char> chars;           // 字节池，所有名称(UTF-8)首尾相接
+    vector<uint32_t> starts;      // 第i个原子的名称起始位置，末尾为哨兵
+    vector<uint32_t> hashes;      // 各原子名称的哈希值(扩容时重新分布)
+    vector<Atom> slots;           // 哈希槽，NO_ATOM表示空槽
+
+    void Grow();                  // 哈希槽扩容一倍
+
+    /**
+     * @brief 按字节访问方式查找或插入名称
+     * @param at 按下标返回名称UTF-8字节的访问函数
+     * @param length 名称字节数
+     * @return 名称对应的原子
+     */
+    template <typename Accessor>
+    Atom InternWith(const Accessor& at, size_t length)
+    {
+        // FNV-1a哈希
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ static_cast<uint32_t>(at(i))) * 16777619u;
+        }
+
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+            Atom atom = slots[slot];
+            if (atom == NO_ATOM) {
+                // 新名称: 追加到字符池
+                atom = static_cast<Atom>(hashes.size());
+                for (size_t i = 0; i < length; i++) {
+                    chars.push_back(static_cast<char>(at(i)));
+                }
+                starts.push_back(static_cast<uint32_t>(chars.size()));
+                hashes.push_back(hash);
+                slots[slot] = atom;
+                if (hashes.size() * 2 > slots.size()) {
+                    Grow();
+                }
+                return atom;
+            }
+            if (hashes[atom] == hash && starts[atom + 1] - starts[atom] == length) {
+                const unsigned char* name = reinterpret_cast<const unsigned char*>(chars.data()) + starts[atom];
+                size_t i = 0;
+                while (i < length && name[i] == static_cast<unsigned char>(at(i))) {
+                    i++;
+                }
+                if (i == length) {
+                    return atom;
+                }
+            }
+        }
+    }
+
+public:
+    AtomTable();
+
+    void Clear();                                         // 清空原子表
+    Atom Intern(const wchar_t* name, size_t length);      // 获取名称对应的原子
+    Atom Intern(const wstring& name) { return Intern(name.data(), name.length()); }
+    Atom InternUtf8(const char* name, size_t length);     // 获取UTF-8名称对应的原子
+    wstring Name(Atom atom) const;                        // 取回原子对应的名称(展宽为宽字符串)
+    string NameUtf8(Atom atom) const;                     // 取回原子对应的名称(UTF-8)
+    size_t Size() const { return hashes.size(); }         // 原子总数
+    size_t GetMemoryBytes() const;                        // 原子表占用的字节数
+
+    /**
+     * @brief 直接从字符源中获取名称对应的原子，不生成中间字符串
+     * @param source 按位置返回字符的字符源，名称须为ASCII(PL/0标识符)
+     * @param start 名称首字符位置
+     * @param length 名称长度
+     */
+    template <typename Source>
+    Atom InternFrom(const Source& source, size_t start, size_t length)
+    {
+        return InternWith([&](size_t i) { return source(start + i); }, length);
+    }
+};
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file Batch.hpp
+ * @brief 批量编译模块
+ * @details 在工作窃取线程池上并行编译(并可运行)一组源程序，
+ *          每个工作线程使用自己的编译上下文，结果按输入顺序汇总输出
+ */
+
+#ifndef _BATCH_HPP
+#define _BATCH_HPP
+
+#include <Types.hpp>
+using namespace std;
+
+/**
+ * @struct BatchOptions
+ * @brief 批量编译选项
+ */
+struct BatchOptions
+{
+    unsigned threads = 0;     // 工作线程数，0表示使用CPU核数
+    bool run = false;         // 编译成功后是否在线程池上运行程序
+};
+
+/**
+ * @struct BatchResult
+ * @brief 单个源程序的编译结果
+ */
+struct BatchResult
+{
+    string filename;              // 源文件路径
+    bool opened = false;          // 文件是否打开成功
+    unsigned errors = 0;          // 错误数
+    unsigned warnings = 0;        // 警告数
+    size_t lines = 0;             // 源程序行数
+    size_t codes = 0;             // 生成的P-Code条数
+    wstring diagnostics;          // 该文件的全部诊断输出
+    wstring output;               // 程序运行输出(未运行时为空)
+};
+
+/**
+ * @struct BatchStats
+ * @brief 批量编译的汇总统计
+ */
+struct BatchStats
+{
+    size_t files = 0;         // 文件数
+    size_t failed = 0;        // 打开失败或有错误的文件数
+    size_t lines = 0;         // 总行数
+    double seconds = 0;       // 总耗时(秒)
+    unsigned threads = 0;     // 工作线程数
+    uint64_t steals = 0;      // 任务窃取次数
+};
+
+vector<string> CollectSources(const string& path);    // 收集目录或列表文件中的源文件
+BatchStats CompileBatch(const vector<string>& files, const BatchOptions& options,
+                        vector<BatchResult>& results);    // 并行编译一组源文件
+void PrintBatchReport(const vector<BatchResult>& results, const BatchStats& stats);    // 按输入顺序输出结果
+void RunBatch();    // 批量编译菜单
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file Benchmark.hpp
+ * @brief 性能测试模块
+ * @details 生成大规模合成PL/0程序，测量编译器各阶段的吞吐量
+ */
+
+#ifndef _BENCHMARK_HPP
+#define _BENCHMARK_HPP
+
+#include <Types.hpp>
+#include <chrono>
+using namespace std;
+
+/**
+ * @brief 生成合成的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param lines 程序体语句行数
+ * @param crlf 是否使用Windows换行(CRLF)，用于测试解码路径
+ * @param errorEvery 每隔多少行插入一条错误语句，0表示不插入
+ * @return 生成文件的字节数
+ */
+size_t GenerateSource(const string& filename, size_t lines, bool crlf = false, size_t errorEvery = 0);
+
+/**
+ * @brief 生成声明大量变量的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param symbols 变量个数
+ * @return 生成文件的字节数
+ */
+size_t GenerateSymbolSource(const string& filename, size_t symbols);
+
+/**
+ * @brief 生成含深度嵌套表达式的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param depth 括号嵌套层数
+ * @return 生成文件的字节数
+ */
+size_t GenerateNestedSource(const string& filename, size_t depth);
+
+/**
+ * @brief 生成含大量常量表达式与常量条件的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param blocks 循环体内重复的语句组数
+ * @return 生成文件的字节数
+ */
+size_t GenerateConstantSource(const string& filename, size_t blocks);
+
+/**
+ * @brief 生成以循环为主的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param outer 外层循环次数(内层固定100次)
+ * @return 生成文件的字节数
+ */
+size_t GenerateLoopSource(const string& filename, size_t outer);
+
+/**
+ * @brief 生成程序体中含大量空行的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param blankLines 空行数
+ * @param crlf 是否使用Windows换行(CRLF)
+ * @return 生成文件的字节数
+ */
+size_t GenerateBlankSource(const string& filename, size_t blankLines, bool crlf = false);
+
+/**
+ * @brief 线性查找保留字(原Reserve的实现，作为完美哈希的对照)
+ * @param word 单词
+ * @return 保留字对应的词法单元类型，不是保留字时返回IDENT
+ */
+unsigned long LinearKeyword(const wstring& word);
+
+void BenchReader();     // 源文件读取后端吞吐量测试
+void BenchSourceStore();    // 分块源程序存储测试
+void BenchDiagnostics();    // 错误诊断输出测试
+void BenchKeywords();       // 保留字查找测试
+void BenchScanner();        // 词法扫描方式测试
+void BenchTokenStream();    // 词法单元序列测试
+void BenchAtoms();          // 标识符原子表测试
+void BenchBlankLines();     // 空行压力测试
+void BenchParallelLex();    // 并行词法分析测试
+void BenchPipeline();       // 词法/语法分析流水线测试
+void BenchAst();            // 语法树模式测试
+void BenchNestedExp();      // 深度嵌套表达式测试
+void BenchSymbolLookup();   // 符号查找测试
+void BenchSymbolStore();    // 符号信息存储测试
+void BenchContexts();       // 多编译上下文并发测试
+void BenchBatch();          // 批量编译测试
+void BenchPeephole();       // 窥孔优化测试
+void BenchFold();           // 常量折叠测试
+void BenchSuper();          // 超级指令测试
+void BenchThreaded();       // 直接线索化执行测试
+void BenchFixedStack();     // 固定容量运行时栈测试
+void BenchFrames();         // 栈深度分析测试
+void RunBenchmark();    // 性能测试菜单
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file Compiler.hpp
+ * @brief 编译上下文模块
+ * @details 一个编译上下文拥有一次编译所需的全部状态：源文件读取器、原子表、
+ *          错误处理器、词法分析器、符号表、指令序列、语法分析器与解释器。
+ *          各上下文互不共享可变状态，多线程宿主可在不同线程上各用一个上下文
+ *          同时编译、运行多个程序而无需加锁
+ */
+
+#ifndef _COMPILER_HPP
+#define _COMPILER_HPP
+
+#include <Types.hpp>
+#include <AtomTable.hpp>
+#include <ErrorHandle.hpp>
+#include <Lexer.hpp>
+#include <SymTable.hpp>
+#include <PCode.hpp>
+#include <Parser.hpp>
+#include <Interpreter.hpp>
+#include <Optimizer.hpp>
+using namespace std;
+
+/**
+ * @class CompilerContext
+ * @brief 编译上下文
+ * @details 成员按依赖顺序构造并互相绑定；同一上下文可反复用于多次编译，
+ *          但同一时刻只应由一个线程使用
+ */
+class CompilerContext
+{
+public:
+    ReadUnicode readUnicode;      // 源文件读取器
+    AtomTable atomTable;          // 标识符原子表
+    ErrorHandle errorHandle;      // 错误处理器
+    Lexer lexer;                  // 词法分析器
+    SymTable symTable;            // 符号表
+    PCodeList pcodelist;          // 指令序列
+    Parser parser;                // 语法分析器
+    Interpreter interpreter;      // 解释器
+
+    CompilerContext();
+    CompilerContext(const CompilerContext&) = delete;
+    CompilerContext& operator=(const CompilerContext&) = delete;
+
+    void Reset();                                                             // 复位各模块，准备下一次编译
+    bool Open(const string& filename, SourceBackend mode = BACKEND_MAPPING);  // 复位并打开源文件
+    bool Compile();                                                           // 分析已打开的源程序
+    bool Compile(const string& filename);                                     // 打开并分析源文件
+    PeepholeStats Optimize(unsigned rules = PEEP_ALL);                        // 窥孔优化生成的P-Code
+    PeepholeStats Fuse();                                                     // 合并超级指令
+    void Run();                                                               // 解释执行生成的P-Code
+};
+
+#endif
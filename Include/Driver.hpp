@@ -0,0 +1,83 @@
+/**
+ * @file Driver.hpp
+ * @brief 命令行驱动模块
+ * @details 由命令行参数指定源文件、执行阶段、转储内容与程序输入，不经菜单交互，
+ *          便于脚本调用；可输出各阶段的耗时与内存报告，定位性能退化发生的阶段
+ */
+
+#ifndef _DRIVER_HPP
+#define _DRIVER_HPP
+
+#include <Types.hpp>
+using namespace std;
+
+/**
+ * @enum DriverPhase
+ * @brief 编译与执行阶段
+ */
+enum DriverPhase {
+    PHASE_READ,         // 读取源文件
+    PHASE_LEX,          // 词法分析
+    PHASE_PARSE,        // 语法分析与代码生成
+    PHASE_OPTIMIZE,     // 优化
+    PHASE_RUN,          // 解释执行
+    PHASE_CNT
+};
+
+/**
+ * @struct DriverOptions
+ * @brief 命令行选项
+ */
+struct DriverOptions
+{
+    string source;                  // 源文件路径
+    string input;                   // 程序输入文件，为空时从控制台读取
+    DriverPhase stop = PHASE_RUN;   // 执行到哪个阶段为止
+    bool dumpPCode = false;         // 输出生成的P-Code
+    bool dumpSymTab = false;        // 输出符号表
+    bool dumpFrames = false;        // 输出各过程的栈使用分析结果
+    bool buildAst = false;          // 经语法树生成P-Code
+    bool foldConstants = false;     // 折叠常量表达式并删除恒真/恒假条件的死分支
+    unsigned peephole = 0;          // 窥孔优化规则(PEEP_*)，0表示不优化
+    bool superinstructions = false; // 合并超级指令
+    bool threaded = false;          // 使用直接线索化执行
+    size_t stackCells = 0;          // 固定运行时栈容量(存储单元数)，0表示按需扩展
+    bool stackAuto = false;         // 固定运行时栈容量取栈深度分析的结果
+    unsigned stackFlags = 0;        // 固定运行时栈选项(STACK_*)
+    bool timeReport = false;        // 输出各阶段耗时与内存报告
+    bool verbose = false;           // 输出读取过程信息
+};
+
+/**
+ * @class TimeReport
+ * @brief 各阶段耗时与内存统计
+ * @details 内存取自进程工作集：峰值为该阶段结束时进程的历史峰值，
+ *          增量为该阶段前后工作集之差
+ */
+class TimeReport
+{
+private:
+    struct PhaseRecord
+    {
+        bool ran = false;           // 该阶段是否执行
+        double seconds = 0;         // 耗时(秒)
+        size_t peakBytes = 0;       // 阶段结束时的峰值工作集
+        long long deltaBytes = 0;   // 工作集增量
+    };
+
+    PhaseRecord phases[PHASE_CNT];  // 各阶段记录
+    chrono::steady_clock::time_point start;   // 当前阶段开始时间
+    size_t startBytes = 0;          // 当前阶段开始时的工作集
+
+public:
+    void Begin();                   // 开始计量一个阶段
+    void End(DriverPhase phase);    // 结束计量并记入指定阶段
+    void Print();                   // 输出报告
+};
+
+bool ParseArguments(int argc, char** argv, DriverOptions& options);  // 解析命令行参数
+int RunDriver(const DriverOptions& options);    // 按选项编译并执行
+int RunCommandLine(int argc, char** argv);      // 命令行入口
+void PrintUsage();                              // 输出用法
+
+#endif
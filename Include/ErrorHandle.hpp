@@ -8,9 +8,10 @@
 #ifndef _ERROR_HANDLE_HPP
 #define _ERROR_HANDLE_HPP
 
-#include <Lexer.hpp>
 #include <Types.hpp>
 
+class Lexer;
+
 /* ============ 控制台颜色定义 ============ */
 enum ConsoleColor {
     COLOR_DEFAULT = 7,      // 默认白色
@@ -38,10 +39,13 @@ enum ErrorLevel {
 class ErrorHandle
 {
 private:
+    Lexer& lexer;                     // 所属编译上下文的词法分析器(取源码行)
+    ReadUnicode& readUnicode;         // 所属编译上下文的源文件读取器
     unsigned int errCnt;              // 错误计数
     unsigned int warnCnt;             // 警告计数
     wstring errMsg[ERR_CNT];          // 错误信息模板表
     wstring currentFileName;          // 当前编译的文件名
+    wostream* out = &wcout;           // 诊断输出流
     
     // 控制台颜色控制
     void setColor(ConsoleColor color);
@@ -68,8 +72,11 @@ private:
                              const wchar_t* suggestion = nullptr);
 
 public:
+    ErrorHandle(Lexer& lexer, ReadUnicode& readUnicode) : lexer(lexer), readUnicode(readUnicode) {}
+
     void InitErrorHandle();
     void SetFileName(const wstring& filename);
+    void SetOutput(wostream& stream) { out = &stream; }    // 设置诊断输出流(非控制台时不着色)
     
     // 标准错误报告接口(保持向后兼容)
     void error(const unsigned int n, const size_t preWordRow, const size_t preWordCol, 
@@ -98,6 +105,4 @@ public:
     void printSummary();
 };
 
-extern ErrorHandle errorHandle;
-
 #endif
@@ -9,6 +9,7 @@
 
 #include <PCode.hpp>
 #include <Types.hpp>
+#include <VmStack.hpp>
 using namespace std;
 
 /* ====== 活动记录布局常量 ====== */
@@ -17,6 +18,21 @@ using namespace std;
 #define GLO_DISPLAY 2         // 全局display指针存放位置
 #define DISPLAY 3             // 局部display起始位置
 
+/**
+ * @struct ThreadedCode
+ * @brief 预译码后的指令
+ * @details 直接线索化执行时每条指令预先确定处理程序，OPR按运算类型、
+ *          CJP/CJI按关系运算、STO/STI按是否传递实参拆成各自的处理程序
+ */
+struct ThreadedCode
+{
+    const void* handler;    // 处理程序地址(标签地址，不支持时为空)
+    int kind;               // 处理程序编号(switch分派使用)
+    int L;                  // 层差
+    int a;                  // 地址或立即数
+    int b;                  // 超级指令的第二个立即数
+};
+
 /**
  * @class Interpreter
  * @brief P-Code解释执行器
@@ -24,10 +40,22 @@ using namespace std;
  */
 class Interpreter {
 public:
+    PCodeList& pcodelist;           // 所属编译上下文的指令序列
     size_t pc;                      // 程序计数器(指向当前指令)
     size_t top;                     // 栈顶指针(下一个可用位置)
     size_t sp;                      // 基址寄存器(当前活动记录基址)
     vector<int> running_stack;      // 运行时数据栈
+    wistream* in = &wcin;           // 程序输入流
+    wostream* out = &wcout;         // 程序输出流
+    size_t dispatched = 0;          // 最近一次运行分派的指令条数
+    bool stackOverflow = false;     // 最近一次运行是否因固定栈容量不足而终止
+
+    Interpreter(PCodeList& pcodelist) : pcodelist(pcodelist) {}
+
+    void SetIO(wistream& input, wostream& output) { in = &input; out = &output; }  // 设置程序输入/输出流
+    void SetThreaded(bool enable) { threaded = enable; }  // 设置是否使用直接线索化执行
+    bool SetFixedStack(size_t cells, unsigned flags = 0);  // 设置固定容量运行时栈，0表示按需扩展
+    VmStack& GetFixedStack() { return fixedStack; }       // 获取固定容量运行时栈
 
     void run();   // 启动解释执行
     
@@ -38,16 +66,31 @@ private:
     void lod(Operation op, int L, int a);   // 加载变量
     void sto(Operation op, int L, int a);   // 存储变量
     void cal(Operation op, int L, int a);   // 过程调用
-    void alc(Operation op, int L, int a);   // 分配栈空间
+    void alc(Operation op, int L, int a, int b);    // 分配栈空间
     void jmp(Operation op, int L, int a);   // 无条件跳转
     void jpc(Operation op, int L, int a);   // 条件跳转
     void red(Operation op, int L, int a);   // 读取输入
     void wrt(Operation op, int L, int a);   // 输出结果
 
+    /* ====== 超级指令的执行函数 ====== */
+    void sti(Operation op, int L, int a, int b);    // 存储常量
+    void adi(Operation op, int L, int a);           // 栈顶加常量
+    void lai(Operation op, int L, int a, int b);    // 取变量加常量
+    void inc(Operation op, int L, int a, int b);    // 变量原地加常量
+    void cjp(Operation op, int L, int a);           // 比较并条件跳转
+    void cji(Operation op, int L, int a, int b);    // 与常量比较并条件跳转
+
     void clear();   // 清空运行时状态
     void Init();    // 初始化解释器
-};
 
-extern Interpreter interpreter;
+    /* ====== 直接线索化执行 ====== */
+    bool threaded = false;          // 是否使用直接线索化执行
+    vector<ThreadedCode> decoded;   // 预译码的指令(跨运行复用)
+    template <bool Fixed>
+    void RunThreaded();             // 直接线索化执行，Fixed表示使用固定容量栈
+
+    /* ====== 固定容量运行时栈 ====== */
+    VmStack fixedStack;             // 固定容量运行时栈，未申请时按需扩展running_stack
+};
 
 #endif
@@ -0,0 +1,46 @@
+/**
+ * @file Optimizer.hpp
+ * @brief P-Code优化模块
+ * @details 窥孔优化在语法分析生成的指令序列上反复匹配短指令窗口并改写，
+ *          删除指令后统一重定位所有跳转与调用目标，直到不再变化；
+ *          超级指令合并把热点指令序列换成解释器原生执行的合并操作码；
+ *          栈深度分析计算各过程的活动记录大小与最大栈高度
+ */
+
+#ifndef _OPTIMIZER_HPP
+#define _OPTIMIZER_HPP
+
+#include <Types.hpp>
+#include <PCode.hpp>
+using namespace std;
+
+/* ====== 窥孔优化规则 ====== */
+const unsigned PEEP_JUMP_CHAIN = 0x01;    // 跳转/条件跳转/调用的目标为JMP时直达最终目标，跳到过程返回的JMP改为返回
+const unsigned PEEP_JUMP_NEXT = 0x02;     // 删除跳到下一条的JMP
+const unsigned PEEP_UNREACHABLE = 0x04;   // 删除不可达指令
+const unsigned PEEP_NEGATE = 0x08;        // LIT c; OPR NEG => LIT -c，连续两次取负抵消
+const unsigned PEEP_IDENTITY = 0x10;      // 删除 +0、-0、*1、/1
+const unsigned PEEP_LOAD_STORE = 0x20;    // 删除取出后原样存回同一单元的LOD/STO
+const unsigned PEEP_ALL = 0x3f;           // 全部规则
+
+/**
+ * @struct PeepholeStats
+ * @brief 窥孔优化统计
+ */
+struct PeepholeStats
+{
+    size_t before = 0;        // 优化前指令数
+    size_t after = 0;         // 优化后指令数
+    size_t retargeted = 0;    // 改变目标的跳转/调用数
+    size_t rewritten = 0;     // 原地改写的指令数
+    size_t removed = 0;       // 删除的指令数
+    unsigned passes = 0;      // 迭代轮数
+};
+
+bool FoldOperation(int op, int lhs, int rhs, int& result);                       // 编译期计算运算结果
+PeepholeStats PeepholeOptimize(PCodeList& pcodelist, unsigned rules = PEEP_ALL);   // 窥孔优化
+bool ParsePeepholeRules(const string& names, unsigned& rules);                   // 由逗号分隔的规则名得到规则集
+PeepholeStats FuseSuperinstructions(PCodeList& pcodelist);                      // 合并常见指令序列为超级指令
+void AnalyzeFrames(PCodeList& pcodelist);                                       // 静态分析各过程的活动记录大小与最大栈深度
+
+#endif
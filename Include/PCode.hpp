@@ -20,11 +20,19 @@ enum Operation {
     load,   // LOD: 取变量值(层差L，偏移a)压入栈顶
     store,  // STO: 栈顶值存入变量(层差L，偏移a)
     call,   // CAL: 调用过程(层差L，入口地址a)
-    alloc,  // INT: 在栈顶分配a个存储单元
+    alloc,  // INT: 在栈顶分配a个存储单元，b为所在过程栈顶的最大高度(0表示未分析)
     jmp,    // JMP: 无条件跳转到地址a
     jpc,    // JPC: 条件跳转，栈顶为0则跳转到地址a
     red,    // RED: 读取输入存入变量(层差L，偏移a)
     wrt,    // WRT: 输出栈顶值
+
+    /* ====== 超级指令: 由FuseSuperinstructions合并常见指令序列得到 ====== */
+    sti,    // STI: 常量b存入变量(层差L，偏移a)，L为-1时传递常量实参      = LIT b; STO L,a
+    adi,    // ADI: 栈顶加常量a                                          = LIT; OPR ADD/SUB
+    lai,    // LAI: 取变量(层差L，偏移a)加常量b压入栈顶                  = LOD L,a; LIT; OPR ADD/SUB
+    inc,    // INC: 变量(层差L，偏移a)原地加常量b                        = LOD L,a; LIT; OPR ADD/SUB; STO L,a
+    cjp,    // CJP: 弹出两个值按关系运算L比较，不成立则跳转到a            = OPR L; JPC a
+    cji,    // CJI: 弹出栈顶与常量b按关系运算L比较，不成立则跳转到a       = LIT b; OPR L; JPC a
 };
 
 /**
@@ -37,8 +45,25 @@ public:
     Operation op;   // 操作码
     int L;          // 层差(level difference)
     int a;          // 地址或立即数
+    int b;          // 超级指令的第二个立即数
+
+    PCode(Operation op1, int L1, int a1, int b1 = 0) : op(op1), L(L1), a(a1), b(b1) {};
+};
 
-    PCode(Operation op1, int L1, int a1) : op(op1), L(L1), a(a1) {};
+/**
+ * @struct FrameInfo
+ * @brief 过程的栈使用分析结果
+ * @details 高度均相对过程的活动记录基址，包括活动记录本身、表达式临时值、
+ *          传递实参与调用时写入的被调过程活动记录头部
+ */
+struct FrameInfo
+{
+    size_t entry = 0;           // 过程入口地址(CAL的目标，主程序为0)
+    size_t allocAt = 0;         // 分配活动记录的INT指令地址
+    int frameSize = 0;          // 活动记录单元数
+    int maxDepth = 0;           // 过程内栈顶的最大高度，0表示无法确定
+    size_t need = 0;            // 连同全部被调过程所需的栈单元数，递归或无法确定时为0
+    bool recursive = false;     // 是否(间接)调用自身
 };
 
 /**
@@ -49,13 +74,14 @@ public:
 class PCodeList {
 public:
     vector<PCode> code_list;    // 指令序列
+    vector<FrameInfo> frames;   // 各过程的栈使用分析结果(AnalyzeFrames填写，改写指令序列后需重新分析)
+    size_t stackBound = 0;      // 整个程序所需的栈单元数，递归或未分析时为0
 
     int emit(Operation op, int L, int a);           // 生成一条指令，返回指令地址
     void backpatch(size_t target, size_t addr);     // 回填跳转地址
     void show();                                     // 显示所有指令
-    void clear() { code_list.clear(); };            // 清空指令序列
+    void showFrames();                               // 显示各过程的栈使用分析结果
+    void clear() { code_list.clear(); frames.clear(); stackBound = 0; };   // 清空指令序列
 };
 
-extern PCodeList pcodelist;
-
 #endif
@@ -0,0 +1,80 @@
+/**
+ * @file SpscRing.hpp
+ * @brief 单生产者单消费者无锁环形队列
+ * @details 生产者与消费者各自只写一个下标，通过acquire/release配对同步，
+ *          无需加锁；槽位中的对象原地复用，稳定运行时不分配内存
+ */
+
+#ifndef _SPSC_RING_HPP
+#define _SPSC_RING_HPP
+
+#include <Types.hpp>
+using namespace std;
+
+/**
+ * @class SpscRing
+ * @brief 单生产者单消费者环形队列
+ * @details 生产者先BeginPush取得空槽、填写后EndPush发布；
+ *          消费者先Front取得队首、处理完后Pop归还。队满或队空时返回空指针，
+ *          由调用者决定等待方式
+ */
+template <typename T>
+class SpscRing
+{
+private:
+    vector<T> slots;                      // 槽位(容量为2的幂)
+    size_t mask;                          // 下标掩码
+    alignas(64) atomic<size_t> head;      // 生产者: 下一个写入位置
+    alignas(64) atomic<size_t> tail;      // 消费者: 下一个读取位置
+
+public:
+    /**
+     * @brief 构造环形队列
+     * @param capacity 槽位数，须为2的幂
+     */
+    explicit SpscRing(size_t capacity) : slots(capacity), mask(capacity - 1), head(0), tail(0) {}
+
+    /**
+     * @brief 生产者: 取得下一个空槽
+     * @return 空槽，队满返回nullptr
+     */
+    T* BeginPush()
+    {
+        size_t h = head.load(memory_order_relaxed);
+        if (h - tail.load(memory_order_acquire) == slots.size()) {
+            return nullptr;
+        }
+        return &slots[h & mask];
+    }
+
+    /**
+     * @brief 生产者: 发布BeginPush取得的槽
+     */
+    void EndPush()
+    {
+        head.store(head.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+
+    /**
+     * @brief 消费者: 取得队首
+     * @return 队首槽，队空返回nullptr
+     */
+    T* Front()
+    {
+        size_t t = tail.load(memory_order_relaxed);
+        if (t == head.load(memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots[t & mask];
+    }
+
+    /**
+     * @brief 消费者: 归还队首槽
+     */
+    void Pop()
+    {
+        tail.store(tail.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+};
+
+#endif
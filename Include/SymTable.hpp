@@ -9,8 +9,11 @@
 
 #include <Types.hpp>
 #include <Lexer.hpp>
+#include <Arena.hpp>
 using namespace std;
 
+class SymTable;
+
 /**
  * @enum Category
  * @brief 符号类别枚举
@@ -27,107 +30,109 @@ enum Category
 };
 
 /**
- * @class Information
- * @brief 符号信息基类
- * @details 存储符号的通用属性，派生类扩展特定类型的属性
+ * @struct FormVar
+ * @brief 形参列表节点
  */
-class Information
+struct FormVar
 {
-public:
-    Category cat;     // 符号类别
-    size_t level;     // 所在层次
-    size_t offset;    // 相对偏移地址
-    size_t entry;     // 入口地址(过程使用)
-
-    Information() : cat(Category::NIL), level(0), offset(0), entry(-1) {};
-
-    virtual void SetValue(wstring value) {}
-    virtual int GetValue() { return -1; }
-    virtual void show();
-    virtual void SetEntry(size_t entry) {};
-    virtual size_t GetEntry() { return -1; };
+    size_t pos;           // 形参在符号表中的位置
+    FormVar* next;        // 下一个形参
 };
 
 /**
- * @class VarInfo
- * @brief 变量信息类
- * @details 存储变量特有的属性，如变量值
+ * @class Information
+ * @brief 符号信息记录
+ * @details 变量、常量、形参与过程共用一种记录，以cat为标签区分；
+ *          记录分配在符号表的线性分配区中，不含虚函数，随每次编译整体复位
  */
-class VarInfo : public Information
+class Information
 {
-private:
-    int value;    // 变量当前值
-
 public:
-    VarInfo() : Information(), value(0) {};
-
-    void SetValue(wstring val) override;
-    void SetValue(int nowValue) { value = nowValue; };
-    int GetValue() override;
-    void show() override;
+    Category cat;             // 符号类别(记录标签)
+    size_t level;             // 所在层次
+    size_t offset;            // 相对偏移地址(过程为栈帧大小)
+    size_t entry;             // 入口地址(过程使用)
+    int value;                // 常量值(非过程使用)
+    bool isDefined;           // 是否已定义(过程使用)
+    size_t formVarCount;      // 形参个数(过程使用)
+    FormVar* formVarList;     // 形参列表(过程使用)
+    FormVar** formVarTail;    // 形参列表尾
+
+    Information() : cat(Category::NIL), level(0), offset(0), entry(-1), value(0), isDefined(false),
+                    formVarCount(0), formVarList(nullptr), formVarTail(&formVarList) {};
+
+    void SetValue(const wstring& val);    // 设置常量值(过程无效)
+    int GetValue();                       // 获取常量值
+    void SetEntry(size_t nowEntry);       // 设置过程入口(非过程无效)
+    size_t GetEntry();                    // 获取过程入口
+    void show(SymTable& symTable);
 };
 
-/**
- * @class ProcInfo
- * @brief 过程信息类
- * @details 存储过程特有的属性，如定义状态和形参列表
- */
-class ProcInfo : public Information
-{
-public:
-    bool isDefined;                 // 是否已定义
-    vector<size_t> formVarList;     // 形参在符号表中的位置列表
-
-    ProcInfo();
-
-    void show() override;
-    void SetEntry(size_t entry) override;
-    size_t GetEntry() override;
-};
+typedef Information VarInfo;    // 变量/常量/形参信息
+typedef Information ProcInfo;   // 过程信息
 
 /**
  * @class SymTableItem
  * @brief 符号表项
- * @details 符号表中的单个条目，包含名称、信息和链接指针
+ * @details 符号表中的单个条目，包含名称原子、信息和链接指针
  */
 class SymTableItem
 {
 public:
     Information* info;    // 符号信息(多态指向具体类型)
-    wstring name;         // 符号名称
+    Atom name;            // 符号名称原子
     size_t previous;      // 同一作用域内前一符号的位置(链式结构)
+    size_t shadow;        // 被本符号遮蔽的同名同类符号的位置(名称索引链)，0表示无
     
-    void show();
+    void show(SymTable& symTable);
 };
 
 /**
  * @class SymTable
  * @brief 符号表管理器
- * @details 管理整个程序的符号表，支持嵌套作用域
+ * @details 管理整个程序的符号表，支持嵌套作用域。
+ *          除按层的display链外，另按名称原子建立索引：过程名与非过程名各一张，
+ *          每个原子对应当前可见的最内层同名符号，其余同名符号经shadow链由内向外相连
  */
 class SymTable
 {
 public:
+    Lexer& lexer;                   // 所属编译上下文的词法分析器(报错位置)
+    ErrorHandle& errorHandle;       // 所属编译上下文的错误处理器
+    AtomTable& atomTable;           // 所属编译上下文的原子表
     size_t sp;                      // 当前作用域链表尾指针
     vector<SymTableItem> table;     // 符号表主体
     vector<size_t> display;         // 层次显示表(每层作用域的链尾位置)
     size_t level;                   // 当前嵌套层次
 
+private:
+    vector<size_t> procIndex;       // 过程名索引(按原子编号，0表示无)
+    vector<size_t> identIndex;      // 非过程名索引(按原子编号，0表示无)
+    Arena infoArena;                // 符号信息与形参列表的分配区
+    bool indexed = true;            // 查找是否使用名称索引
+
+    int SearchChain(Atom name, Category cat);                     // 沿display链逐层查找
+    int SearchIndex(Atom name, Category cat);                     // 按名称索引查找
+
 public:
-    SymTable() : sp(0), level(0) { display.resize(1, 0); };
+    SymTable(Lexer& lexer, ErrorHandle& errorHandle, AtomTable& atomTable)
+        : lexer(lexer), errorHandle(errorHandle), atomTable(atomTable), sp(0), level(0) { display.resize(1, 0); };
 
     SymTableItem GetTable(int num);                               // 获取指定位置的符号表项
-    void PopDisplay() { display.pop_back(); }                     // 退出当前作用域
+    void PushDisplay();                                           // 进入新作用域
+    void PopDisplay();                                            // 退出当前作用域
+    void SetIndexed(bool on) { indexed = on; }                    // 设置查找方式(默认按名称索引)
 
-    void EnterProgm(wstring name);                                // 进入主程序
+    void EnterProgm(Atom name);                                   // 进入主程序
     void showAll();                                               // 显示整个符号表
-    int InsertToTable(wstring name, size_t offset, Category cat); // 插入新符号
-    int SearchInfo(wstring name, Category cat);                   // 查找符号
+    int InsertToTable(Atom name, size_t offset, Category cat);    // 插入新符号
+    int SearchInfo(Atom name, Category cat);                      // 查找符号
     void MkTable();                                               // 创建新作用域
     void InitAndClear();                                          // 初始化并清空符号表
     void AddWidth(size_t addr, size_t width);                     // 更新过程的栈帧大小
+    void AddFormVar(ProcInfo* proc, size_t pos);                  // 追加过程形参
+    size_t GetMemoryBytes();                                      // 获取本次编译符号表占用的堆内存
+    size_t GetInfoBytes() { return infoArena.GetUsedBytes(); }    // 获取符号信息已分配字节数
 };
 
-extern SymTable symTable;
-
 #endif
@@ -0,0 +1,65 @@
+/**
+ * @file ThreadPool.hpp
+ * @brief 工作窃取线程池
+ * @details 每个工作线程有自己的任务队列，先处理本队列中的任务，
+ *          本队列为空时从其他线程的队列尾部窃取，任务耗时不均时各线程仍能同时结束
+ */
+
+#ifndef _THREAD_POOL_HPP
+#define _THREAD_POOL_HPP
+
+#include <Types.hpp>
+using namespace std;
+
+/**
+ * @class WorkStealingPool
+ * @brief 工作窃取线程池
+ * @details 线程在构造时创建、析构时结束，可多次提交任务批次。
+ *          每批任务编号为0..count-1，按连续区段分给各线程；
+ *          调用Run的线程作为0号工作线程一同执行，全部任务完成后Run才返回
+ */
+class WorkStealingPool
+{
+public:
+    typedef function<void(size_t task, unsigned worker)> Task;
+
+private:
+    /**
+     * @struct WorkQueue
+     * @brief 单个工作线程的任务队列
+     * @details 所有者从队首取任务，窃取者从队尾取，两端竞争很少
+     */
+    struct alignas(64) WorkQueue
+    {
+        mutex lock;               // 队列锁
+        deque<size_t> tasks;      // 待执行的任务编号
+    };
+
+    vector<WorkQueue> queues;         // 各工作线程的任务队列
+    vector<thread> workers;           // 1号起的工作线程
+    mutex jobLock;                    // 保护以下批次状态
+    condition_variable jobReady;      // 新批次就绪或线程池关闭
+    condition_variable jobDone;       // 本批次各线程均已结束
+    const Task* job = nullptr;        // 当前批次的任务函数
+    uint64_t generation = 0;          // 批次序号
+    unsigned active = 0;              // 本批次尚未结束的工作线程数
+    bool stopping = false;            // 线程池正在关闭
+    atomic<uint64_t> steals;          // 累计窃取次数
+
+    void WorkerLoop(unsigned worker);             // 工作线程主循环
+    void Drain(unsigned worker, const Task& task);    // 执行任务直到所有队列为空
+    bool Pop(unsigned worker, size_t& task);      // 从本队列取任务
+    bool Steal(unsigned worker, size_t& task);    // 从其他队列窃取任务
+
+public:
+    explicit WorkStealingPool(unsigned threads = 0);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void Run(size_t count, const Task& task);                       // 执行一批任务并等待完成
+    unsigned GetThreadCount() { return (unsigned)queues.size(); }   // 工作线程数(含调用线程)
+    uint64_t GetSteals() { return steals.load(); }                  // 累计窃取次数
+};
+
+#endif
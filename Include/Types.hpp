@@ -11,12 +11,21 @@
 #include <locale>
 #include <string>
 #include <cstddef>
+#include <climits>
 #include <fcntl.h>
 #include <fstream>
 #include <io.h>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <algorithm>
+#include <new>
 #include <stdint.h>
 #include <sys/stat.h>
 #include <stdio.h>
@@ -26,6 +35,7 @@
 #include <unordered_map>
 #include <vector>
 #include <windows.h>
+#include <psapi.h>
 #include <ostream>
 
 using namespace std;
@@ -114,7 +124,7 @@ const int ERR_CNT = 70;         // 错误类型总数
 /* ============================================================
  *                   P-Code虚拟机相关常量
  * ============================================================ */
-#define P_CODE_CNT 10         // P-Code指令种类数
+#define P_CODE_CNT 16         // P-Code指令种类数(含超级指令)
 #define UNIT_SIZE 4           // 单个存储单元字节数
 #define ACT_PRE_REC_SIZE 3    // 活动记录预留空间(RA+DL+Display指针)
 
@@ -135,11 +145,6 @@ const int ERR_CNT = 70;         // 错误类型总数
 #define OPR_PRINT 13          // 输出(不换行)
 #define OPR_PRINTLN 14        // 输出(换行)
 
-/* ============================================================
- *                      全局变量声明
- * ============================================================ */
-extern size_t glo_offset;     // 全局偏移量，用于计算变量地址
-
 #ifndef UNICODE
 #define UNICODE
 #endif
@@ -153,7 +158,7 @@ extern size_t glo_offset;     // 全局偏移量，用于计算变量地址
  * @param numStr 待转换的数字字符串
  * @return 转换后的整数，失败返回0
  */
-int w_str2int(wstring numStr);
+int w_str2int(const wstring& numStr);
 
 /**
  * @brief 整数转宽字符串
@@ -163,17 +168,45 @@ int w_str2int(wstring numStr);
 wstring int2w_str(int num);
 
 /* ============================================================
- *              Unicode文件读取器 (带缓冲区)
+ *              Unicode文件读取器 (分块存储)
  * ============================================================ */
 
 // 缓冲区大小常量
-const size_t BUFFER_SIZE = 1024;  // 字符缓冲区大小
+const size_t CHUNK_SHIFT = 12;                    // 分块大小的对数
+const size_t CHUNK_SIZE = 1 << CHUNK_SHIFT;       // 每块字符数(4096)
+const size_t CHUNK_MASK = CHUNK_SIZE - 1;         // 块内偏移掩码
+const size_t RAW_BUFFER_SIZE = 16384;             // 流式后端原始字节缓冲区大小
+const size_t RETAIN_ALL = 0;                      // 保留全部已加载字符(不淘汰)
+
+/**
+ * @enum DecodeStatus
+ * @brief 批量UTF-8解码结果
+ */
+enum DecodeStatus {
+    DECODE_OK,          // 输入耗尽或输出已满
+    DECODE_PARTIAL,     // 输入末尾为不完整的多字节序列，需要补充字节
+    DECODE_INVALID      // 遇到非法UTF-8字节
+};
+
+/**
+ * @enum SourceBackend
+ * @brief 源文件读取后端
+ */
+enum SourceBackend {
+    BACKEND_STREAM,     // ifstream逐字节读取，缓冲区按需加载
+    BACKEND_MAPPING     // 内存映射整个文件，纯ASCII时零拷贝直接访问
+};
 
 /**
  * @class ReadUnicode
- * @brief 带缓冲区的UTF-8源文件读取器
- * @details 采用缓冲区按需加载机制，不一次性读取整个文件
- *          当请求的字符位置超出当前缓冲区时，自动加载下一块数据
+ * @brief 分块存储的UTF-8源文件读取器
+ * @details 解码后的字符按CHUNK_SIZE分块存放，位置到块为移位运算，
+ *          任意已保留位置O(1)访问；请求位置超出已加载范围时按需加载后续块。
+ *          可配置回看窗口：只保留最近若干字符所在的块，更早的块回收复用，
+ *          大文件内存占用保持平稳；默认全部保留，供回退与诊断任意访问。
+ *          映射后端下若文件为合法UTF-8且不含CR，则不解码、不复制，
+ *          词法分析器可通过GetDirectData()直接按字节访问映射内存，位置为字节偏移，
+ *          多字节字符由读到它的一方解码，只在输出时才展宽
  */
 class ReadUnicode
 {
@@ -182,27 +215,125 @@ private:
     bool isFileOpen;                    // 文件是否已打开
     bool reachedEnd;                    // 是否已读到文件末尾
     
-    wchar_t buffer[BUFFER_SIZE];        // 字符缓冲区
-    size_t bufferStartPos;              // 缓冲区首字符对应的全局位置
-    size_t bufferLength;                // 缓冲区当前有效字符数
+    vector<wchar_t*> chunks;            // 分块存储(已淘汰的块为空)
+    vector<wchar_t*> freeChunks;        // 回收待复用的块
+    size_t loadedLength;                // 已加载的字符数(含结束标记)
+    size_t retainChunks;                // 回看窗口块数，RETAIN_ALL表示全部保留
+    size_t firstRetained;               // 最早仍保留的块号
     size_t totalCharsLoaded;            // 已加载的总字符数
+
+    SourceBackend backend;              // 当前使用的读取后端
+    HANDLE hFile;                       // 映射后端: 文件句柄
+    HANDLE hMapping;                    // 映射后端: 映射对象句柄
+    const unsigned char* mapView;       // 映射视图起始地址
+    const unsigned char* mapBegin;      // 源程序起始地址(已跳过BOM)
+    const unsigned char* mapEnd;        // 源程序结束地址
+    bool isDirect;                      // 是否可按字节直接访问映射内存(UTF-8)
+
+    unsigned char rawBuffer[RAW_BUFFER_SIZE];   // 流式后端原始字节缓冲区
+    const unsigned char* rawCursor;     // 待解码字节起始(流式指向rawBuffer，映射指向映射区)
+    const unsigned char* rawEnd;        // 待解码字节结束
+    wostream* log;                      // 读取过程信息输出流
     
     // 内部辅助方法
-    int calcUtf8Length(unsigned char byte);     // 计算UTF-8字符长度
-    bool readOneChar(wchar_t& outChar);         // 从文件读取一个字符
-    bool loadNextBuffer();                      // 加载下一块缓冲区
+    bool fillRawBuffer();                       // 流式后端补充原始字节
+    DecodeStatus decodeBlock(wchar_t* out, size_t outCap, size_t& outLen);  // 批量校验并解码
+    bool loadNextBuffer();                      // 加载下一块
+    wchar_t* allocChunk();                      // 分配(或复用)一块
+    void releaseChunks();                       // 释放全部块
+    wchar_t loadUntil(const size_t pos);        // 加载直到覆盖指定位置
+    bool mapFile(const string& filename);       // 映射整个文件
+    void unmapFile();                           // 解除文件映射
 
 public:
     ReadUnicode();
     ~ReadUnicode();
     
     void InitReadUnicode();                     // 初始化/重置读取器
-    void readFile2USC2(string filename);        // 打开文件准备读取
-    wchar_t getProgmWStr(const size_t pos);     // 获取指定位置的字符
+    void readFile2USC2(string filename, SourceBackend mode = BACKEND_MAPPING);  // 打开文件准备读取
+    inline wchar_t getProgmWStr(const size_t pos);  // 获取指定位置的单元(直接访问时为字节)
     bool isEmpty();                             // 判断是否为空
     size_t getLoadedCount();                    // 获取已加载字符数
+    void SetRetention(size_t chars);            // 设置回看窗口字符数，RETAIN_ALL表示全部保留
+    bool IsRetained(const size_t pos);          // 指定位置是否仍可访问
+    size_t GetRetainedBytes();                  // 当前分块存储占用的字节数
+    SourceBackend GetBackend() { return backend; }                            // 获取当前后端
+    const unsigned char* GetDirectData() { return isDirect ? mapBegin : nullptr; }  // 直接访问指针(不可直接访问时为空)
+    size_t GetDirectLength() { return mapEnd - mapBegin; }                  // 直接访问区长度
+    void SetLog(wostream& stream) { log = &stream; }                          // 设置读取过程信息输出流
 };
 
-extern ReadUnicode readUnicode;
+/**
+ * @brief 统计连续的ASCII字节数
+ * @param data 字节序列
+ * @param length 序列长度
+ * @return 从起始处开始、不含高位字节与CR的连续字节数
+ * @details 按16/32字节分块向量化检测(SSE2/AVX2)，不支持时退回逐字节检测
+ */
+size_t ScanAscii(const unsigned char* data, size_t length);
+
+/**
+ * @brief 统计合法UTF-8的前缀字节数
+ * @param data 字节序列
+ * @param length 序列长度
+ * @param chars 输出该前缀包含的字符数
+ * @return 从起始处开始、编码合法且不含CR的连续字节数
+ * @details ASCII部分经ScanAscii整块跳过，多字节字符按流式解码的规则逐个校验
+ */
+size_t ScanUtf8(const unsigned char* data, size_t length, size_t& chars);
+
+int calcUtf8Length(unsigned char byte);     // 计算UTF-8字符长度
+
+/**
+ * @brief 解码一个UTF-8字符
+ * @param data 多字节字符的首字节位置(>= 0x80)，调用者保证编码合法(经ScanUtf8校验)
+ * @param bytes 输出该字符的字节数
+ * @return 字符，与流式解码的结果一致
+ */
+inline wchar_t DecodeUtf8(const unsigned char* data, size_t& bytes)
+{
+    int charLen = calcUtf8Length(data[0]);
+    bytes = charLen;
+    wchar_t codepoint = data[0] & (0xFF >> (charLen + 1));
+    for (int i = 1; i < charLen; ++i) {
+        codepoint = (codepoint << 6) | (data[i] & 0x3F);
+    }
+    return codepoint;
+}
+
+/**
+ * @brief 统计连续的相同字节数
+ * @param data 字节序列
+ * @param length 序列长度
+ * @param byte 目标字节
+ * @return 从起始处开始、连续等于byte的字节数
+ */
+size_t ScanRun(const unsigned char* data, size_t length, unsigned char byte);
+
+/**
+ * @brief 获取指定位置的源程序单元
+ * @param pos 单元在源程序中的全局位置(从0开始)
+ * @return 指定位置的单元，文件末尾为'#'，无效或已淘汰的位置返回'\0'
+ * @details 解码模式下单元为字符：命中已加载的块时直接按块号与块内偏移取字符，
+ *          超出已加载范围时由loadUntil按需加载。
+ *          直接访问模式(GetDirectData()非空)下单元为字节：pos是字节偏移，
+ *          多字节字符返回的是其中的单个UTF-8字节(>= 0x80)，
+ *          需要字符的调用者遇到 >= 0x80 的字节时应以DecodeUtf8从GetDirectData()+pos处解码并按字节数前进
+ */
+inline wchar_t ReadUnicode::getProgmWStr(const size_t pos)
+{
+    // 直接访问映射内存，文件末尾之后紧跟结束标记'#'
+    if (isDirect) {
+        size_t length = mapEnd - mapBegin;
+        if (pos < length) return mapBegin[pos];
+        return pos == length ? L'#' : L'\0';
+    }
+
+    if (pos < loadedLength) {
+        const wchar_t* chunk = chunks[pos >> CHUNK_SHIFT];
+        return chunk ? chunk[pos & CHUNK_MASK] : L'\0';
+    }
+    return loadUntil(pos);
+}
 
 #endif
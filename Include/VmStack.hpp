@@ -0,0 +1,47 @@
+/**
+ * @file VmStack.hpp
+ * @brief 固定容量运行时栈模块
+ * @details 执行前一次性申请整个运行时栈，压栈只是一次存储；
+ *          可由VirtualAlloc映射并在末尾设置不可访问的保护页，也可尝试使用大页
+ */
+
+#ifndef _VM_STACK_HPP
+#define _VM_STACK_HPP
+
+#include <Types.hpp>
+using namespace std;
+
+const unsigned STACK_GUARD = 0x01;          // 栈末尾设置不可访问的保护页
+const unsigned STACK_HUGE_PAGES = 0x02;     // 尝试使用大页(需要锁定内存页权限，失败时退回普通页)
+const size_t VM_STACK_DEFAULT = 1 << 20;    // 默认固定栈容量(存储单元数)
+
+/**
+ * @class VmStack
+ * @brief 固定容量运行时栈
+ * @details 不带选项时从堆上申请并清零；带选项时由VirtualAlloc映射(内容为零)，
+ *          容量向上取整到页大小，Capacity()为取整后的单元数。大页不能单独修改页保护，因此使用大页时不设保护页。
+ *          溢出由解释器按Capacity()在INT与传递实参时检查，保护页只是检查遗漏时的兜底
+ */
+class VmStack
+{
+private:
+    int* base = nullptr;        // 栈底
+    size_t capacity = 0;        // 可用存储单元数
+    size_t bytes = 0;           // 映射的字节数(含保护页)，0表示从堆上申请
+    unsigned flags = 0;         // 实际生效的选项
+
+public:
+    VmStack() = default;
+    ~VmStack() { Release(); }
+    VmStack(const VmStack&) = delete;
+    VmStack& operator=(const VmStack&) = delete;
+
+    bool Allocate(size_t cells, unsigned request);  // 申请固定容量的栈
+    void Release();                                 // 释放栈空间
+
+    int* Data() { return base; }                    // 获取栈底
+    size_t Capacity() { return capacity; }          // 获取可用存储单元数
+    unsigned Flags() { return flags; }              // 获取实际生效的选项
+};
+
+#endif
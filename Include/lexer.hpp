@@ -8,9 +8,109 @@
 #define _LEXER_HPP
 
 #include <Types.hpp>
+#include <AtomTable.hpp>
 #include <ErrorHandle.hpp>
+#include <SpscRing.hpp>
 using namespace std;
 
+/**
+ * @enum ScanMode
+ * @brief 词法扫描方式
+ */
+enum ScanMode {
+    SCAN_CLASSIC,       // 逐字符判断的if/else分支扫描
+    SCAN_DFA            // 字符类表与状态转移表驱动的DFA扫描
+};
+
+const size_t PARALLEL_MIN_CHUNK = 1 << 20;  // 并行词法分析时每块的最小字节数
+const size_t PIPELINE_BATCH = 1024;         // 流水线模式每批词法单元数
+const size_t PIPELINE_RING_SIZE = 64;       // 流水线环形队列槽数(2的幂)
+
+/**
+ * @struct Token
+ * @brief 紧凑的词法单元记录
+ * @details 不保存字符串，只记录在源程序中的位置与长度；同时保存扫描结束后的
+ *          行列号、标识符原子与当前字符，回放时可还原语法分析可见的全部状态。共36字节
+ */
+struct Token
+{
+    uint32_t type;            // 词法单元类型
+    uint32_t offset;          // 首字符在源程序中的位置
+    uint32_t length;          // 长度
+    uint32_t row;             // 结束处行号
+    uint32_t col;             // 结束处列号
+    uint32_t preRow;          // 上一合法词法单元的结束行号
+    uint32_t preCol;          // 上一合法词法单元的结束列号
+    Atom atom;                // 标识符原子(非标识符为NO_ATOM)
+    wchar_t ch;               // 扫描结束后的当前字符
+};
+
+static_assert(sizeof(Token) == 36, "Token must stay a 36-byte record");
+
+/**
+ * @struct LexDiag
+ * @brief 整体词法分析时暂存的词法错误，回放到所属词法单元时再报告
+ */
+struct LexDiag
+{
+    size_t token;             // 所属词法单元序号
+    unsigned int n;           // 错误类型
+    wstring extra;            // 附加信息
+    size_t preRow, preCol;    // 上一词法单元结束位置
+    size_t row, col;          // 当前位置
+};
+
+/**
+ * @struct TokenBatch
+ * @brief 流水线模式下词法分析线程交给语法分析的一批词法单元
+ * @details 除词法单元外，还带有本批暂存的词法错误、新记录的行首，
+ *          以及本批首次出现的标识符名称(UTF-8，按原子顺序首尾相接)
+ */
+struct TokenBatch
+{
+    vector<Token> tokens;         // 词法单元
+    vector<LexDiag> diags;        // 词法错误(token为批内序号)
+    vector<size_t> lines;         // 新记录的行首位置
+    string names;                 // 新原子的名称
+    vector<uint32_t> nameEnds;    // 各新原子名称在names中的结束位置
+    Atom firstAtom = 0;           // 第一个新原子(扫描线程私有编号)
+    size_t end = 0;               // 本批结束时的读取位置
+    bool last = false;            // 是否为最后一批
+};
+
+struct TokenPipeline;
+
+/**
+ * @class SourceSpan
+ * @brief 源程序片段视图
+ * @details 类似string_view，按位置访问源程序存储，不复制字符；
+ *          直接访问UTF-8源程序时按字节访问
+ */
+class SourceSpan
+{
+private:
+    ReadUnicode* reader;      // 源程序存储
+    size_t offset;            // 首字符位置
+    size_t length;            // 长度
+
+public:
+    SourceSpan(ReadUnicode* reader, size_t offset, size_t length) : reader(reader), offset(offset), length(length) {}
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    wchar_t operator[](size_t i) const { return reader->getProgmWStr(offset + i); }
+    wstring str() const;                          // 复制为wstring
+    bool operator==(const wstring& other) const;  // 与字符串比较
+};
+
+/**
+ * @brief 查找保留字
+ * @param word 单词字符序列
+ * @param length 单词长度
+ * @return 保留字对应的词法单元类型，不是保留字返回IDENT
+ * @details 按长度与前两个字符计算完美哈希，一次比较即可判定
+ */
+unsigned long LookupKeyword(const wchar_t* word, size_t length);
+
 /**
  * @class Lexer
  * @brief 词法分析器
@@ -20,22 +120,36 @@ class Lexer
 {
 private:
     wchar_t ch;                   // 当前读入的字符
+    size_t chStart;               // 当前字符在源程序中的位置(多字节字符为首字节)
     unsigned long tokenType;      // 当前识别的词法单元类型
     wstring strToken;             // 当前词法单元的字符串值
+    size_t tokenStart;            // DFA扫描: 当前词法单元首字符位置
+    size_t tokenLength;           // DFA扫描: 当前词法单元长度
+    bool tokenPending;            // DFA扫描: strToken尚未按位置生成
+    Atom tokenAtom;               // 当前词法单元的原子(标识符识别时分配)
+
+    vector<Token> tokens;         // 整体词法分析得到的词法单元序列
+    vector<LexDiag> diags;        // 整体词法分析时暂存的词法错误
+    size_t tokensEnd;             // 整体词法分析结束时的读取位置
+    size_t tokenCursor;           // 回放位置
+    size_t diagCursor;            // 下一条待报告的词法错误
+    bool deferring;               // 是否暂存词法错误(整体词法分析中)
+    bool replaying;               // 是否回放词法单元序列
     size_t nowPtr;                // 当前字符在源程序中的位置
     size_t rowPos;                // 当前行号
     size_t colPos;                // 当前列号
     size_t preWordRow;            // 上一合法词法单元的结束行号
     size_t preWordCol;            // 上一合法词法单元的结束列号
+    vector<size_t> lineStarts;    // 行首索引: 第k行首字符位置为lineStarts[k-1]
+    ScanMode scanMode = SCAN_DFA; // 扫描方式
+    ReadUnicode* reader = nullptr;  // 源文件读取器(所属编译上下文)
+    ErrorHandle* errors = nullptr;  // 错误处理器(所属编译上下文)
+    AtomTable* atoms = nullptr;     // 标识符原子表(并行分块扫描时为各块私有)
+    TokenPipeline* pipeline = nullptr;  // 流水线模式: 与词法分析线程共享的状态
+    size_t chunkEnd = SIZE_MAX;   // 分块扫描: 本块结束位置，扫描到此处视为源程序结束
 
     unordered_map<unsigned long, wstring> sym_map;  // 词法单元类型到字符串的映射
 
-    // 保留字表
-    wstring resv_table[RSV_WORD_MAX] = {
-        L"odd", L"begin", L"end", L"if", L"then", L"while", L"do", L"call",
-        L"const", L"var", L"procedure", L"write", L"read", L"program", L"else"
-    };
-
     // 运算符表
     wchar_t opr_table[OPR_MAX] = {
         L'+', L'-', L'*', L'/', L'=', L'<', L'>', L'(', L')', L',', L';'
@@ -46,23 +160,71 @@ private:
     bool IsBoundary();    // 判断当前字符是否为界符
     int IsOperator();     // 判断当前字符是否为运算符
     void GetBC();         // 跳过空白字符
+    wchar_t SourceAt(size_t pos);  // 读取源程序指定位置的字符
     void GetChar();       // 读取下一个字符
     void Retract();       // 回退一个字符
-    int Reserve();        // 查找保留字表
+    unsigned long Reserve();  // 查找保留字，返回词法单元类型
     void Concat();        // 将当前字符追加到strToken
+    void MaterializeToken();  // 按记录的位置生成strToken
+    void ResetScan();         // 重置扫描位置与状态
+    bool ReplayNext();        // 回放下一个词法单元，序列结束返回false
+    bool PullNext();          // 流水线模式: 取下一个词法单元，全部取完返回false
+    void LoadToken(const Token& token, size_t end);  // 按词法单元记录还原扫描状态
+    void PushToken();         // 把当前词法单元追加到词法单元序列
+    void Produce(TokenPipeline* pipe);  // 词法分析线程: 分批扫描并送入环形队列
+    void Report(const unsigned int n, const wstring& extra);  // 报告(或暂存)词法错误
+    void RecordLine();    // 记录刚读过的换行符之后的行首位置
+    bool ScanDFA();       // 表驱动扫描，遇到错误状态返回false
+    template <typename Source>
+    bool ScanTable(const Source& source);  // 按给定的字符访问方式执行表驱动扫描
+    void ScanTokens();    // 扫描到源程序结束，追加到词法单元序列
+    void ScanChunk(size_t begin, size_t end, AtomTable* table);  // 扫描一个按行切分的源程序块
+    void TokenizeParallel(unsigned threads);  // 多线程分块词法分析并拼接结果
 
 public:
+    Lexer() = default;                                // 分块扫描与流水线使用的内部词法分析器
+    Lexer(ReadUnicode& reader, ErrorHandle& errors, AtomTable& atoms) : reader(&reader), errors(&errors), atoms(&atoms) {}
+
     void GetWord();                                   // 获取下一个词法单元
     void InitLexer();                                 // 初始化词法分析器
+    void Tokenize(unsigned threads = 1);              // 整体词法分析，随后GetWord回放(threads为0时按CPU核数)
+    bool StartPipeline();                             // 启动词法分析线程，随后GetWord从队列取词法单元
+    void StopPipeline();                              // 停止词法分析线程
+    void SetScanMode(ScanMode mode) { scanMode = mode; };  // 设置扫描方式
+    ScanMode GetScanMode() { return scanMode; };      // 获取扫描方式
     wchar_t GetCh();                                  // 获取当前字符
     size_t GetPreWordCol() { return preWordCol; };    // 获取上一词法单元列号
     size_t GetPreWordRow() { return preWordRow; };    // 获取上一词法单元行号
     size_t GetColPos() { return colPos; };            // 获取当前列号
     size_t GetRowPos() { return rowPos; };            // 获取当前行号
-    wstring GetStrToken() { return strToken; };       // 获取当前词法单元字符串
+    const wstring& GetStrToken() { if (tokenPending) MaterializeToken(); return strToken; };  // 获取当前词法单元字符串
+    Atom GetAtom();                                   // 获取当前词法单元的原子
+    SourceSpan GetTokenText() { return SourceSpan(reader, tokenStart, tokenPending ? tokenLength : strToken.length()); };  // 获取当前词法单元的源程序片段
+    const vector<Token>& GetTokens() { return tokens; };  // 获取整体词法分析的词法单元序列
     unsigned long GetTokenType() { return tokenType; }; // 获取当前词法单元类型
+    size_t GetLineCount() { return lineStarts.size(); };  // 获取已索引的行数
+    size_t GetLineStart(size_t line) { return lineStarts[line - 1]; };  // 获取指定行(从1开始)的行首位置
 };
 
-extern Lexer lexer;
+/**
+ * @struct TokenPipeline
+ * @brief 流水线模式的共享状态
+ * @details 词法分析线程在独立的词法分析器上扫描，使用私有原子表，
+ *          经环形队列按批交给语法分析线程；消费端按出现顺序把私有原子映射到全局原子表
+ */
+struct TokenPipeline
+{
+    SpscRing<TokenBatch> ring;        // 批次队列
+    Lexer scanner;                    // 词法分析线程上的词法分析器
+    AtomTable table;                  // 词法分析线程私有的原子表
+    thread producer;                  // 词法分析线程
+    atomic<bool> stop;                // 要求词法分析线程提前结束
+    TokenBatch* current = nullptr;    // 消费端: 正在消费的批次
+    size_t cursor = 0;                // 消费端: 批内下一个词法单元
+    size_t diagCursor = 0;            // 消费端: 批内下一条词法错误
+    vector<Atom> remap;               // 消费端: 私有原子到全局原子的映射
+
+    TokenPipeline() : ring(PIPELINE_RING_SIZE), stop(false) {}
+};
 
 #endif
@@ -12,6 +12,22 @@
 #include <SymTable.hpp>
 #include <Lexer.hpp>
 #include <PCode.hpp>
+#include <Ast.hpp>
+#include <Optimizer.hpp>
+
+/**
+ * @struct ExpFrame
+ * @brief 显式栈表达式分析中一层括号的状态
+ */
+struct ExpFrame
+{
+    AstNode* exp = nullptr;       // 本层已归约的表达式
+    AstNode* term = nullptr;      // 当前项
+    unsigned long aop = NUL;      // 正负号或待归约的加减运算符
+    unsigned long nop = NUL;      // 待归约的乘除运算符
+    bool firstTerm = false;       // 正在分析本层第一项
+    bool firstFactor = false;     // 正在分析当前项的第一个因子
+};
 
 /**
  * @class Parser
@@ -21,6 +37,13 @@
 class Parser
 {
 private:
+    Lexer& lexer;               // 所属编译上下文的词法分析器
+    SymTable& symTable;         // 所属编译上下文的符号表
+    ErrorHandle& errorHandle;   // 所属编译上下文的错误处理器
+    PCodeList& pcodelist;       // 所属编译上下文的指令序列
+    AtomTable& atomTable;       // 所属编译上下文的原子表
+    size_t glo_offset = 0;      // 当前分程序已分配的变量偏移量
+
     /* ====== FIRST集定义 ====== */
     unsigned long firstProg = PROGM_SYM;                    // 程序的FIRST集
     unsigned long firstCondecl = CONST_SYM;                 // 常量声明的FIRST集
@@ -53,20 +76,71 @@ private:
     unsigned long followLop = followExp | followFactor;     // 关系运算符的FOLLOW集
     unsigned long followId = COMMA | SEMICOLON | LPAREN | RPAREN | followFactor;  // 标识符的FOLLOW集
 
+    bool tokenizeAll = false;   // 分析前是否先整体词法分析
+    unsigned tokenizeThreads = 1;  // 整体词法分析的线程数
+    bool pipelined = false;     // 是否由独立的词法分析线程供给词法单元
+    bool buildAst = false;      // 是否先建立语法树再降级生成P-Code
+    Arena astArena;             // 语法树节点的分配区(每次编译复位)
+    AstNode* astRoot = nullptr; // 语法树根(主程序的AST_PROC节点)
+    AstNode** procTail = &astRoot;  // 当前分程序过程列表的追加位置
+    bool recursiveExp = false;  // 表达式是否经exp/term/factor递归分析(否则使用显式栈)
+    vector<ExpFrame> expStack;  // 显式栈表达式分析的帧栈(跨调用复用)
+    bool foldConstants = false; // 是否在编译期计算常量表达式并删除恒真/恒假条件的死分支
+
+    /* ====== 代码生成: 直接模式生成P-Code并返回空，语法树模式建立节点 ====== */
+    AstNode* NewNode(AstKind kind, int L = 0, int a = 0);  // 分配语法树节点
+    AstNode* GenLit(int L, int a);                       // 常量
+    AstNode* GenLoad(int L, int a);                      // 取变量
+    AstNode* GenUnary(int op, AstNode* operand);         // 一元运算
+    AstNode* GenBinary(int op, AstNode* lhs, AstNode* rhs);  // 二元运算
+    AstNode* GenAssign(AstNode* value, VarInfo* target); // 赋值
+    int GenJump(Operation op, int a = 0);                // 跳转(语法树模式只作标记)
+    void GenPatch(int entry);                            // 回填跳转到当前位置
+    AstNode* GenIf(AstNode* cond, AstNode* thenPart, AstNode* elsePart, bool hasJpc, bool hasJmp);  // 条件语句
+    AstNode* GenWhile(AstNode* cond, AstNode* loopBody, bool hasBody);  // 循环语句
+    AstNode* GenArg(AstNode* value, ProcInfo* callee, size_t index);   // 传递第index个实参
+    AstNode* GenCall(AstNode* args, ProcInfo* callee, bool hasCall);   // 调用语句
+    AstNode* GenReadVar(VarInfo* target);                // 读入一个变量
+    AstNode* GenRead(AstNode* targets);                  // 读语句
+    AstNode* GenPrint(AstNode* value);                   // 输出一项
+    AstNode* GenWrite(AstNode* items);                   // 写语句(结束后换行)
+    AstNode* GenSeq(AstNode* list);                      // 语句序列
+    AstNode* BeginProc();                                // 过程(含主程序)开始
+    void GenProcEntry(AstNode* node, Information* info); // 过程入口JMP
+    void GenReturn(AstNode* node, AstNode* blockNode);   // 分程序结束后的返回指令
+
+    /* ====== 常量折叠 ====== */
+    bool ConstOperand(AstNode* node, size_t depth, int& value);  // 操作数是否为刚生成的常量
+    bool FoldCondition(AstNode* cond, size_t start, int& value);  // 条件为常量时取出其值并撤销其代码
+    AstNode* DropCode(size_t mark);       // 丢弃死分支生成的代码
+
 public:
-    void block();       // 分程序处理
-    void proc();        // 过程声明处理
-    void statement();   // 语句处理
-    void constA();      // 常量定义处理
-    void condecl();     // 常量声明处理
-    void vardecl();     // 变量声明处理
-    void term();        // 项处理
-    void factor();      // 因子处理
-    void prog();        // 程序处理
-    void body();        // 复合语句处理
-    void lexp();        // 条件表达式处理
-    void exp();         // 表达式处理
-    void analyze();     // 启动语法分析
+    Parser(Lexer& lexer, SymTable& symTable, ErrorHandle& errorHandle, PCodeList& pcodelist, AtomTable& atomTable)
+        : lexer(lexer), symTable(symTable), errorHandle(errorHandle), pcodelist(pcodelist), atomTable(atomTable) {}
+
+    AstNode* block();       // 分程序处理
+    void proc();            // 过程声明处理
+    AstNode* statement();   // 语句处理
+    void constA();          // 常量定义处理
+    void condecl();         // 常量声明处理
+    void vardecl();         // 变量声明处理
+    AstNode* term();        // 项处理
+    AstNode* factor();      // 因子处理
+    AstNode* operand();     // 标识符或数字常量因子
+    void prog();            // 程序处理
+    AstNode* body();        // 复合语句处理
+    AstNode* lexp();        // 条件表达式处理
+    AstNode* exp();         // 表达式处理
+    AstNode* expRecursive();  // 递归下降的表达式处理
+    AstNode* expExplicit();   // 显式栈的表达式处理
+    void analyze();         // 启动语法分析
+    void SetTokenizeAll(bool enable, unsigned threads = 1) { tokenizeAll = enable; tokenizeThreads = threads; }  // 设置是否先整体词法分析及线程数
+    void SetPipelined(bool enable) { pipelined = enable; }  // 设置是否启用词法/语法分析流水线
+    void SetBuildAst(bool enable) { buildAst = enable; }    // 设置是否经语法树生成P-Code
+    void SetRecursiveExp(bool enable) { recursiveExp = enable; }  // 设置表达式是否递归下降分析
+    void SetFoldConstants(bool enable) { foldConstants = enable; }  // 设置是否折叠常量表达式与常量条件
+    const AstNode* GetAst() { return astRoot; }             // 获取最近一次编译的语法树(语法树模式)
+    Arena& GetAstArena() { return astArena; }               // 获取语法树分配区
 
     // 错误报告
     void reportError(unsigned int errorType, const wchar_t* expected, const wchar_t* context);
@@ -76,6 +150,4 @@ public:
               const wchar_t* extra1, const wchar_t* extra2);
 };
 
-extern Parser parser;
-
 #endif
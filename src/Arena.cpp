@@ -0,0 +1,59 @@
+/**
+ * @file Arena.cpp
+ * @brief 线性分配区实现
+ */
+
+#include <Arena.hpp>
+
+/**
+ * @brief 释放全部块
+ */
+Arena::~Arena()
+{
+    for (char* block : blocks) {
+        delete[] block;
+    }
+}
+
+/**
+ * @brief 申请新块并在其中分配
+ * @param bytes 字节数
+ * @param align 对齐要求
+ * @return 内存起始地址
+ * @details 新块成为当前块；请求超过块大小时按请求大小单独申请
+ */
+void* Arena::Grow(size_t bytes, size_t align)
+{
+    size_t size = max(blockSize, bytes + align);
+    char* block = new char[size];
+    if (blocks.empty()) {
+        firstSize = size;
+    }
+    blocks.push_back(block);
+    reserved += size;
+    cursor = block;
+    limit = block + size;
+
+    char* p = (char*)(((uintptr_t)cursor + align - 1) & ~(uintptr_t)(align - 1));
+    used += p + bytes - cursor;
+    cursor = p + bytes;
+    return p;
+}
+
+/**
+ * @brief 整体复位
+ * @details 之前分配的对象全部失效；保留第一块供下次编译复用，其余块归还系统
+ */
+void Arena::Reset()
+{
+    for (size_t i = 1; i < blocks.size(); i++) {
+        delete[] blocks[i];
+    }
+    if (!blocks.empty()) {
+        blocks.resize(1);
+        cursor = blocks[0];
+        limit = blocks[0] + firstSize;
+        reserved = firstSize;
+    }
+    used = 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file Ast.cpp
+ * @brief 语法树降级实现
+ * @details 按源程序顺序遍历语法树生成P-Code，指令顺序、跳转回填与过程入口
+ *          均与语法分析器直接生成时一致
+ */
+
+#include <Ast.hpp>
+
+/**
+ * @brief 依次降级列表中的节点
+ */
+static void LowerList(const AstNode* node, PCodeList& code)
+{
+    for (; node; node = node->next) {
+        LowerAst(node, code);
+    }
+}
+
+/**
+ * @brief 降级表达式
+ * @details 表达式可能嵌套极深，用显式栈做后序遍历，不占用调用栈
+ */
+static void LowerExp(const AstNode* root, PCodeList& code)
+{
+    vector<pair<const AstNode*, bool>> stack;   // 节点，子节点是否已展开
+    stack.push_back(make_pair(root, false));
+    while (!stack.empty())
+    {
+        const AstNode* node = stack.back().first;
+        bool expanded = stack.back().second;
+        stack.pop_back();
+        if (node == nullptr) {
+            continue;
+        }
+        switch (node->kind)
+        {
+        case AST_LIT:
+            code.emit(lit, node->L, node->a);
+            break;
+        case AST_LOAD:
+            code.emit(load, node->L, node->a);
+            break;
+        case AST_UNARY:
+            if (expanded) {
+                code.emit(opr, 0, node->op);
+            }
+            else {
+                stack.push_back(make_pair(node, true));
+                stack.push_back(make_pair(node->left, false));
+            }
+            break;
+        case AST_BINARY:
+            if (expanded) {
+                if (node->op != OPR_NONE) {
+                    code.emit(opr, 0, node->op);
+                }
+            }
+            else {
+                stack.push_back(make_pair(node, true));
+                stack.push_back(make_pair(node->right, false));
+                stack.push_back(make_pair(node->left, false));
+            }
+            break;
+        default:
+            LowerAst(node, code);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 由语法树生成P-Code
+ * @param node 语法树节点(可为空)
+ * @param code 目标指令序列
+ * @details 过程入口在生成其JMP时写回过程信息，调用与分程序回填在其后读取，
+ *          与直接生成时读到的值相同
+ */
+void LowerAst(const AstNode* node, PCodeList& code)
+{
+    if (node == nullptr) {
+        return;
+    }
+    switch (node->kind)
+    {
+    case AST_LIT:
+        code.emit(lit, node->L, node->a);
+        break;
+    case AST_LOAD:
+        code.emit(load, node->L, node->a);
+        break;
+    case AST_UNARY:
+    case AST_BINARY:
+        LowerExp(node, code);
+        break;
+    case AST_ASSIGN:
+        LowerAst(node->left, code);
+        if (node->flags & AST_HAS_TARGET) {
+            code.emit(store, node->L, node->a);
+        }
+        break;
+    case AST_IF:
+    {
+        LowerAst(node->left, code);
+        if (node->flags & AST_HAS_JPC) {
+            int entry_jpc = code.emit(jpc, 0, 0);
+            LowerAst(node->right, code);
+            if (node->flags & AST_HAS_JMP) {
+                int entry_jmp = code.emit(jmp, 0, 0);
+                code.backpatch(entry_jpc, code.code_list.size());
+                LowerAst(node->other, code);
+                code.backpatch(entry_jmp, code.code_list.size());
+            }
+            else
+                code.backpatch(entry_jpc, code.code_list.size());
+        }
+        else if (node->flags & AST_HAS_JMP) {
+            int entry_jmp = code.emit(jmp, 0, 0);
+            LowerAst(node->other, code);
+            code.backpatch(entry_jmp, code.code_list.size());
+        }
+        break;
+    }
+    case AST_WHILE:
+    {
+        size_t condition = code.code_list.size();
+        if (node->flags & AST_NO_COND) {
+            LowerAst(node->right, code);
+            code.emit(jmp, 0, condition);
+            break;
+        }
+        LowerAst(node->left, code);
+        size_t loop = code.emit(jpc, 0, 0);
+        if (node->flags & AST_HAS_BODY) {
+            LowerAst(node->right, code);
+            code.emit(jmp, 0, condition);
+        }
+        code.backpatch(loop, code.code_list.size());
+        break;
+    }
+    case AST_ARG:
+        LowerAst(node->left, code);
+        code.emit(store, -1, node->a);
+        break;
+    case AST_CALL:
+        LowerList(node->left, code);
+        if (node->flags & AST_HAS_TARGET) {
+            code.emit(call, node->L, node->info->entry);
+        }
+        break;
+    case AST_READ:
+        for (const AstNode* target = node->left; target; target = target->next) {
+            code.emit(red, 0, 0);
+            code.emit(store, target->L, target->a);
+        }
+        break;
+    case AST_PRINT:
+        LowerAst(node->left, code);
+        code.emit(wrt, 0, 0);
+        break;
+    case AST_WRITE:
+        LowerList(node->left, code);
+        code.emit(opr, 0, 13);
+        break;
+    case AST_SEQ:
+        LowerList(node->left, code);
+        break;
+    case AST_BLOCK:
+    {
+        LowerList(node->left, code);
+        size_t entry = code.emit(alloc, 0, node->a);
+        code.backpatch(node->info->entry, entry);
+        LowerAst(node->right, code);
+        break;
+    }
+    case AST_PROC:
+        if (node->info) {
+            size_t entry = code.emit(jmp, 0, 0);
+            node->info->SetEntry(entry);
+        }
+        LowerAst(node->right, code);
+        if (node->flags & AST_HAS_RETURN) {
+            code.emit(opr, 0, OPR_RETURN);
+        }
+        break;
+    }
+}
+
+/**
+ * @brief 统计语法树节点数
+ * @param node 根节点(可为空)
+ * @return 以node为根的子树及其后续兄弟节点的总数
+ */
+size_t CountAstNodes(const AstNode* node)
+{
+    size_t count = 0;
+    vector<const AstNode*> stack;
+    stack.push_back(node);
+    while (!stack.empty())
+    {
+        node = stack.back();
+        stack.pop_back();
+        if (node == nullptr) {
+            continue;
+        }
+        count++;
+        stack.push_back(node->next);
+        stack.push_back(node->left);
+        stack.push_back(node->right);
+        if (node->kind == AST_IF) {
+            stack.push_back(node->other);
+        }
+    }
+    return count;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file AtomTable.cpp
+ * @brief 标识符原子表实现
+ */
+
+#include <AtomTable.hpp>
+
+/**
+ * @brief 构造空的原子表
+ */
+AtomTable::AtomTable()
+{
+    Clear();
+}
+
+/**
+ * @brief 清空原子表
+ * @details 之前分配的原子全部失效，每次编译开始时调用
+ */
+void AtomTable::Clear()
+{
+    chars.clear();
+    hashes.clear();
+    starts.assign(1, 0);
+    slots.assign(ATOM_INIT_SLOTS, NO_ATOM);
+}
+
+/**
+ * @brief 哈希槽扩容一倍
+ * @details 按保存的哈希值重新分布，无需重新计算
+ */
+void AtomTable::Grow()
+{
+    slots.assign(slots.size() * 2, NO_ATOM);
+    size_t mask = slots.size() - 1;
+    for (Atom atom = 0; atom < hashes.size(); atom++) {
+        size_t slot = hashes[atom] & mask;
+        while (slots[slot] != NO_ATOM) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = atom;
+    }
+}
+
+/**
+ * @brief 获取名称对应的原子
+ * @param name 名称字符序列
+ * @param length 名称长度
+ * @return 名称对应的原子，首次出现时分配新原子
+ */
+Atom AtomTable::Intern(const wchar_t* name, size_t length)
+{
+    size_t i = 0;
+    while (i < length && name[i] < 0x80) {
+        i++;
+    }
+    if (i == length) {
+        return InternWith([name](size_t k) { return name[k]; }, length);
+    }
+
+    // 含非ASCII字符: 先编码为UTF-8
+    string utf8;
+    for (i = 0; i < length; i++) {
+        uint32_t c = static_cast<uint32_t>(name[i]);
+        if (c < 0x80) {
+            utf8 += static_cast<char>(c);
+        }
+        else if (c < 0x800) {
+            utf8 += static_cast<char>(0xC0 | (c >> 6));
+            utf8 += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000) {
+            utf8 += static_cast<char>(0xE0 | (c >> 12));
+            utf8 += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else {
+            utf8 += static_cast<char>(0xF0 | (c >> 18));
+            utf8 += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            utf8 += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return InternWith([&utf8](size_t k) { return static_cast<unsigned char>(utf8[k]); }, utf8.length());
+}
+
+/**
+ * @brief 获取UTF-8名称对应的原子
+ * @param name 名称字节序列
+ * @param length 名称字节数
+ * @return 名称对应的原子，首次出现时分配新原子
+ */
+Atom AtomTable::InternUtf8(const char* name, size_t length)
+{
+    return InternWith([name](size_t k) { return static_cast<unsigned char>(name[k]); }, length);
+}
+
+/**
+ * @brief 取回原子对应的名称
+ * @param atom 原子
+ * @return 展宽后的名称，无效原子返回空串
+ * @details 名称以UTF-8存放，在此解码为宽字符串，供控制台输出
+ */
+wstring AtomTable::Name(Atom atom) const
+{
+    if (atom >= hashes.size()) {
+        return L"";
+    }
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(chars.data()) + starts[atom];
+    const unsigned char* end = reinterpret_cast<const unsigned char*>(chars.data()) + starts[atom + 1];
+    wstring name;
+    name.reserve(end - p);
+    while (p < end) {
+        size_t bytes = 1;
+        wchar_t c = *p;
+        if (c >= 0x80) {
+            c = DecodeUtf8(p, bytes);
+        }
+        name += c;
+        p += bytes;
+    }
+    return name;
+}
+
+/**
+ * @brief 取回原子对应的UTF-8名称
+ * @param atom 原子
+ * @return 名称字节序列，无效原子返回空串
+ */
+string AtomTable::NameUtf8(Atom atom) const
+{
+    if (atom >= hashes.size()) {
+        return "";
+    }
+    return string(chars.data() + starts[atom], starts[atom + 1] - starts[atom]);
+}
+
+/**
+ * @brief 获取原子表占用的字节数
+ */
+size_t AtomTable::GetMemoryBytes() const
+{
+    return chars.capacity()
+         + (starts.capacity() + hashes.capacity() + slots.capacity()) * sizeof(uint32_t);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file Batch.cpp
+ * @brief 批量编译模块实现
+ * @details 诊断与程序输出写入各文件自己的缓冲区，读取器的过程信息丢弃，
+ *          编译期间各线程不访问控制台，全部完成后再按输入顺序统一输出
+ */
+
+#include <Batch.hpp>
+#include <Compiler.hpp>
+#include <ThreadPool.hpp>
+
+/**
+ * @brief 收集源文件
+ * @param path 目录或列表文件路径
+ * @return 源文件路径列表
+ * @details 目录: 其中全部.txt文件，按文件名排序；
+ *          列表文件: 每行一个源文件路径，忽略空行
+ */
+vector<string> CollectSources(const string& path)
+{
+    vector<string> files;
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    if (attributes == INVALID_FILE_ATTRIBUTES) {
+        return files;
+    }
+
+    if (attributes & FILE_ATTRIBUTE_DIRECTORY) {
+        WIN32_FIND_DATAA data;
+        HANDLE find = FindFirstFileA((path + "/*.txt").c_str(), &data);
+        if (find == INVALID_HANDLE_VALUE) {
+            return files;
+        }
+        do {
+            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                files.push_back(path + "/" + data.cFileName);
+            }
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+        sort(files.begin(), files.end());
+        return files;
+    }
+
+    ifstream list(path);
+    string line;
+    while (getline(list, line)) {
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == string::npos) {
+            continue;
+        }
+        size_t end = line.find_last_not_of(" \t\r");
+        files.push_back(line.substr(begin, end - begin + 1));
+    }
+    return files;
+}
+
+/**
+ * @brief 并行编译一组源文件
+ * @param files 源文件路径列表
+ * @param options 批量编译选项
+ * @param results 输出各文件的结果，与files一一对应
+ * @return 汇总统计
+ * @details 每个工作线程复用一个编译上下文；运行程序时输入流为空，
+ *          读语句读入0
+ */
+BatchStats CompileBatch(const vector<string>& files, const BatchOptions& options, vector<BatchResult>& results)
+{
+    results.assign(files.size(), BatchResult());
+    wostream discard(nullptr);    // 无缓冲区的流，写入被忽略
+    WorkStealingPool pool(options.threads);
+    vector<CompilerContext> contexts(pool.GetThreadCount());
+    for (CompilerContext& context : contexts) {
+        context.readUnicode.SetLog(discard);
+    }
+
+    auto start = chrono::steady_clock::now();
+    pool.Run(files.size(), [&](size_t task, unsigned worker) {
+        CompilerContext& context = contexts[worker];
+        BatchResult& result = results[task];
+        result.filename = files[task];
+
+        wostringstream diagnostics;
+        context.errorHandle.SetOutput(diagnostics);
+        result.opened = context.Open(result.filename);
+        if (result.opened) {
+            context.errorHandle.SetFileName(wstring(result.filename.begin(), result.filename.end()));
+            context.Compile();
+            result.errors = context.errorHandle.GetErrorCount();
+            result.warnings = context.errorHandle.GetWarningCount();
+            result.lines = context.lexer.GetLineCount();
+            result.codes = context.pcodelist.code_list.size();
+
+            if (options.run && result.errors == 0) {
+                wistringstream input;
+                wostringstream output;
+                context.interpreter.SetIO(input, output);
+                context.Run();
+                result.output = output.str();
+            }
+        }
+        result.diagnostics = diagnostics.str();
+    });
+
+    BatchStats stats;
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.files = files.size();
+    stats.threads = pool.GetThreadCount();
+    stats.steals = pool.GetSteals();
+    for (const BatchResult& result : results) {
+        stats.lines += result.lines;
+        if (!result.opened || result.errors > 0) {
+            stats.failed++;
+        }
+    }
+    for (CompilerContext& context : contexts) {
+        context.errorHandle.SetOutput(wcout);
+        context.interpreter.SetIO(wcin, wcout);
+    }
+    return stats;
+}
+
+/**
+ * @brief 按输入顺序输出各文件的结果与吞吐量
+ * @param results 各文件的结果
+ * @param stats 汇总统计
+ * @details 有错误或警告的文件附带其完整诊断，运行过的程序附带其输出
+ */
+void PrintBatchReport(const vector<BatchResult>& results, const BatchStats& stats)
+{
+    for (const BatchResult& result : results) {
+        wstring name(result.filename.begin(), result.filename.end());
+        if (!result.opened) {
+            wcout << L"[Error] " << name << L": 文件打开失败" << endl;
+            continue;
+        }
+        wcout << (result.errors > 0 ? L"[Error] " : L"[OK] ") << name << L": " << result.lines
+              << L" lines, " << result.codes << L" codes, " << result.errors << L" error(s), "
+              << result.warnings << L" warning(s)" << endl;
+        if (result.errors > 0 || result.warnings > 0) {
+            wcout << result.diagnostics;
+        }
+        if (!result.output.empty()) {
+            wcout << result.output;
+        }
+    }
+
+    double seconds = max(stats.seconds, 1e-9);
+    wcout << L"─────────────────────────────────────────────────────────" << endl;
+    wcout << L"文件: " << stats.files << L" (失败 " << stats.failed << L"), 行数: " << stats.lines
+          << L", 线程: " << stats.threads << L", 窃取: " << stats.steals << endl;
+    wcout << L"耗时: " << fixed << setprecision(3) << stats.seconds * 1000 << L" ms, "
+          << setprecision(1) << stats.files / seconds << L" files/s, "
+          << stats.lines / seconds << L" lines/s" << endl;
+}
+
+/**
+ * @brief 批量编译菜单
+ */
+void RunBatch()
+{
+    string path;
+    wcout << L"=== 批量编译 ===" << endl;
+    wcout << L"请输入源文件目录或列表文件(如 test): ";
+    if (!(cin >> path)) {
+        return;
+    }
+    vector<string> files = CollectSources(path);
+    if (files.empty()) {
+        wcout << L"未找到源文件" << endl;
+        return;
+    }
+
+    BatchOptions options;
+    string run;
+    wcout << L"工作线程数(0为CPU核数): ";
+    cin >> options.threads;
+    wcout << L"是否运行程序(y/n): ";
+    cin >> run;
+    options.run = (run == "y" || run == "Y");
+
+    vector<BatchResult> results;
+    BatchStats stats = CompileBatch(files, options, results);
+    PrintBatchReport(results, stats);
+}
@@ -0,0 +1,1231 @@
+/**
+ * @file Benchmark.cpp
+ * @brief 性能测试模块实现
+ * @details 各项测试在test目录下生成临时源文件，测试完成后删除；
+ *          计时期间屏蔽编译器的控制台输出，避免打印开销干扰结果
+ */
+
+#include <Benchmark.hpp>
+#include <Compiler.hpp>
+#include <Batch.hpp>
+
+// 临时测试文件目录
+static const string BENCH_DIR = "test/";
+
+/**
+ * @class NullWBuf
+ * @brief 丢弃所有输出的宽字符流缓冲区
+ */
+class NullWBuf : public wstreambuf
+{
+protected:
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+    streamsize xsputn(const wchar_t*, streamsize n) override { return n; }
+};
+
+/**
+ * @class Silence
+ * @brief 作用域内屏蔽wcout输出
+ */
+class Silence
+{
+private:
+    NullWBuf nullBuf;
+    wstreambuf* saved;
+
+public:
+    Silence() : saved(wcout.rdbuf(&nullBuf)) {}
+    ~Silence() { wcout.rdbuf(saved); }
+};
+
+/**
+ * @brief 获取当前时间(秒)
+ */
+static double Now()
+{
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 生成合成的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param lines 程序体语句行数
+ * @param crlf 是否使用Windows换行(CRLF)，用于测试解码路径
+ * @param errorEvery 每隔多少行插入一条错误语句，0表示不插入
+ * @return 生成文件的字节数
+ * @details 循环使用若干语句模板，生成的程序语法与语义均合法；
+ *          插入的错误语句误用'='赋值，每条恰好产生一个错误
+ */
+size_t GenerateSource(const string& filename, size_t lines, bool crlf, size_t errorEvery)
+{
+    static const char* templates[] = {
+        "    a := a + 1;",
+        "    b := (a * 3 - b) / 2 + counter;",
+        "    if a > b then c := a else c := b;",
+        "    while c > 100 do c := c - 100;",
+        "    counter := counter + c * 2 - (a - b);",
+        "    if odd counter then counter := 0;",
+    };
+    const size_t templateCnt = sizeof(templates) / sizeof(templates[0]);
+    const char* eol = crlf ? "\r\n" : "\n";
+
+    ofstream out(filename, ios::out | ios::binary);
+    out << "program bench;" << eol
+        << "const limit := 1000;" << eol
+        << "var a, b, c, counter;" << eol
+        << "begin" << eol
+        << "    a := 0;" << eol;
+    for (size_t i = 0; i < lines; i++) {
+        if (errorEvery && i % errorEvery == errorEvery - 1) {
+            out << "    a = a + 1;" << eol;
+        }
+        else {
+            out << templates[i % templateCnt] << eol;
+        }
+    }
+    out << "    counter := limit" << eol
+        << "end" << eol;
+    return static_cast<size_t>(out.tellp());
+}
+
+/**
+ * @brief 生成声明大量变量的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param symbols 变量个数
+ * @return 生成文件的字节数
+ * @details 变量名共享较长前缀；每条赋值语句引用两个不同的变量，
+ *          符号查找次数与变量个数成正比
+ */
+size_t GenerateSymbolSource(const string& filename, size_t symbols)
+{
+    ofstream out(filename, ios::out | ios::binary);
+    out << "program symbols;\nvar ";
+    for (size_t i = 0; i < symbols; i++) {
+        out << "symbol" << i << (i + 1 < symbols ? (i % 10 == 9 ? ",\n    " : ", ") : ";\n");
+    }
+    out << "begin\n    symbol0 := 1;\n";
+    for (size_t i = 1; i < symbols; i++) {
+        out << "    symbol" << i << " := symbol" << i - 1 << " + symbol" << (i * 7) % symbols << ";\n";
+    }
+    out << "    symbol0 := 0\nend\n";
+    return static_cast<size_t>(out.tellp());
+}
+
+/**
+ * @brief 生成含深度嵌套表达式的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param depth 括号嵌套层数
+ * @return 生成文件的字节数
+ * @details 唯一的赋值语句形如 a := (1 + (2 * (3 - (... (a) ...))))，
+ *          每层一个括号因子和一个二元运算，每64层换行
+ */
+size_t GenerateNestedSource(const string& filename, size_t depth)
+{
+    static const char ops[] = { '+', '*', '-', '/' };
+    ofstream out(filename, ios::out | ios::binary);
+    out << "program nested;\nvar a;\nbegin\n    a := ";
+    for (size_t i = 0; i < depth; i++) {
+        out << '(' << i % 9 + 1 << ' ' << ops[i % 4] << ' ' << (i % 64 == 63 ? "\n" : "");
+    }
+    out << 'a';
+    for (size_t i = 0; i < depth; i++) {
+        out << (i % 64 == 63 ? ")\n" : ")");
+    }
+    out << "\nend\n";
+    return static_cast<size_t>(out.tellp());
+}
+
+/**
+ * @brief 生成含大量常量表达式与常量条件的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param blocks 循环体内重复的语句组数
+ * @return 生成文件的字节数
+ * @details 每组语句含一个常量子表达式、一个恒假的调试输出和一个条件恒定的if-else，
+ *          循环末尾另有一个恒假的while
+ */
+size_t GenerateConstantSource(const string& filename, size_t blocks)
+{
+    ofstream out(filename, ios::out | ios::binary);
+    out << "program fold;\nconst n := 1000, scale := 4, debug := 0;\nvar i, s;\nbegin\n"
+        << "    i := 0;\n    s := 0;\n    while i < n * scale / 2 do\n    begin\n";
+    for (size_t k = 0; k < blocks; k++) {
+        out << "        s := s + (scale * " << k % 7 + 1 << " + 1) - n / " << k % 5 + 10 << ";\n"
+            << "        if debug = 1 then write(s, " << k << ");\n"
+            << "        if odd (scale + " << k << ") then s := s - " << k << " * 2 else s := s + (" << k << " - 1) * 3;\n";
+    }
+    out << "        while debug > 0 do s := 0;\n        i := i + 1\n    end;\n    write(s)\nend\n";
+    return static_cast<size_t>(out.tellp());
+}
+
+/**
+ * @brief 生成以循环为主的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param outer 外层循环次数(内层固定100次)
+ * @return 生成文件的字节数
+ * @details 两层while循环，内层做算术、比较与一次过程调用，只在最后输出一次
+ */
+size_t GenerateLoopSource(const string& filename, size_t outer)
+{
+    ofstream out(filename, ios::out | ios::binary);
+    out << "program loop;\nvar i, j, s, t;\n"
+        << "procedure mix(x);\nbegin\n    if odd x then t := t + x else t := t - x / 2\nend\n"
+        << "begin\n    s := 0;\n    t := 0;\n    i := 0;\n    while i < " << outer << " do\n    begin\n"
+        << "        j := 0;\n        while j < 100 do\n        begin\n"
+        << "            s := s + i * j - (j / 3);\n            if s > 100000 then s := s - 100000;\n"
+        << "            call mix(j);\n            j := j + 1\n        end;\n        i := i + 1\n    end;\n"
+        << "    write(s, t)\nend\n";
+    return static_cast<size_t>(out.tellp());
+}
+
+/**
+ * @brief 生成程序体中含大量空行的PL/0测试程序
+ * @param filename 输出文件路径
+ * @param blankLines 空行数
+ * @param crlf 是否使用Windows换行(CRLF)
+ * @return 生成文件的字节数
+ * @details 空行位于begin与唯一一条语句之间，程序共有blankLines + 5行
+ */
+size_t GenerateBlankSource(const string& filename, size_t blankLines, bool crlf)
+{
+    const string eol = crlf ? "\r\n" : "\n";
+    ofstream out(filename, ios::out | ios::binary);
+    out << "program blank;" << eol << "var a;" << eol << "begin" << eol;
+    const size_t perWrite = 1 << 20;    // 每次写入的空行数
+    string blanks;
+    for (size_t i = 0; i < perWrite; i++) {
+        blanks += eol;
+    }
+    for (size_t left = blankLines; left > 0; ) {
+        size_t n = min(left, perWrite);
+        out.write(blanks.data(), n * eol.size());
+        left -= n;
+    }
+    out << "    a := 1" << eol << "end" << eol;
+    return static_cast<size_t>(out.tellp());
+}
+
+/**
+ * @brief 屏蔽控制台输出并计时
+ * @param body 被测代码
+ * @return 耗时(秒)
+ */
+static double Timed(const function<void()>& body)
+{
+    Silence silence;
+    double start = Now();
+    body();
+    return Now() - start;
+}
+
+/**
+ * @brief 输出测试文件大小
+ * @param bytes 文件字节数
+ * @param note 附加说明
+ * @return 文件大小(MB)
+ */
+static double PrintSource(size_t bytes, const wstring& note = L"")
+{
+    double mb = bytes / (1024.0 * 1024.0);
+    wcout << L"测试文件: " << fixed << setprecision(2) << mb << L" MB" << note << endl;
+    return mb;
+}
+
+/**
+ * @brief 输出一项测量结果的公共部分(不换行，调用者可继续追加)
+ * @param name 显示名称
+ * @param count 计数
+ * @param unit 计数单位
+ * @param seconds 耗时(秒)
+ * @param mb 处理的数据量(MB)，为0时不输出吞吐量
+ */
+static void PrintRate(const wstring& name, size_t count, const wchar_t* unit, double seconds, double mb = 0)
+{
+    wcout << L"  " << name << L": " << setw(9) << count << L" " << unit << L", "
+          << fixed << setprecision(3) << seconds * 1000 << L" ms";
+    if (mb > 0) {
+        wcout << L", " << setprecision(1) << mb / seconds << L" MB/s";
+    }
+}
+
+/**
+ * @brief 屏蔽输出打开源文件
+ * @param context 编译上下文
+ * @param filename 源文件路径
+ * @return 文件打开成功返回true
+ */
+static bool OpenSilently(CompilerContext& context, const string& filename)
+{
+    Silence silence;
+    return context.Open(filename);
+}
+
+/**
+ * @brief 打开源文件并计时完整语法分析
+ * @param context 编译上下文，各项模式由调用者事先设置
+ * @param filename 源文件路径
+ * @return 语法分析耗时(秒)，不含读取
+ */
+static double TimeCompile(CompilerContext& context, const string& filename)
+{
+    OpenSilently(context, filename);
+    return Timed([&]() { context.parser.analyze(); });
+}
+
+/**
+ * @brief 屏蔽输出编译源文件并按级别优化
+ * @param context 编译上下文
+ * @param filename 源文件路径
+ * @param level 0不优化，1窥孔优化，2再合并超级指令
+ * @return 编译成功返回true
+ */
+static bool Prepare(CompilerContext& context, const string& filename, int level = 0)
+{
+    Silence silence;
+    if (!context.Compile(filename)) {
+        return false;
+    }
+    if (level >= 1) {
+        context.Optimize();
+    }
+    if (level >= 2) {
+        context.Fuse();
+    }
+    return true;
+}
+
+/**
+ * @brief 重复运行已编译的程序并计时
+ * @param context 编译上下文
+ * @param rounds 运行次数
+ * @param input 程序输入，默认读语句依次读入10
+ * @param fresh 是否每次运行前清空按需扩展的运行时栈，以计入扩展的开销
+ * @return 总耗时(秒)
+ * @details 每次运行都从相同的输入开始，程序输出丢弃
+ */
+static double TimeRuns(CompilerContext& context, int rounds, const wstring& input = L"10 10 10 10", bool fresh = false)
+{
+    wostream discard(nullptr);
+    double elapsed = 0;
+    for (int round = 0; round < rounds; round++) {
+        wistringstream in(input);
+        context.interpreter.SetIO(in, discard);
+        if (fresh) {
+            vector<int>().swap(context.interpreter.running_stack);
+        }
+        elapsed += Timed([&]() { context.Run(); });
+    }
+    context.interpreter.SetIO(wcin, wcout);
+    return elapsed;
+}
+
+/**
+ * @brief 词法分析已打开的源程序直到结束
+ * @param lexer 词法分析器
+ * @return 识别出的词法单元数
+ */
+static size_t CountTokens(Lexer& lexer)
+{
+    size_t tokens = 0;
+    lexer.GetWord();
+    while (lexer.GetCh() != L'\0') {
+        tokens++;
+        lexer.GetWord();
+    }
+    return tokens;
+}
+
+/**
+ * @brief 源文件读取后端吞吐量测试
+ * @details 分别以流式与内存映射后端打开同一文件，经getProgmWStr
+ *          顺序读取全部字符，报告MB/s；CRLF文件无法直接访问，
+ *          用于测量批量解码路径
+ */
+void BenchReader()
+{
+    CompilerContext context;
+    string filename = BENCH_DIR + "bench_reader.txt";
+    const bool crlfModes[] = { false, true };
+    const SourceBackend backends[] = { BACKEND_STREAM, BACKEND_MAPPING };
+    for (bool crlf : crlfModes) {
+        double mb = PrintSource(GenerateSource(filename, 250000, crlf), crlf ? L" (CRLF)" : L" (LF)");
+        for (SourceBackend backend : backends) {
+            size_t chars = 0;
+            double elapsed = Timed([&]() {
+                context.readUnicode.readFile2USC2(filename, backend);
+                // 直接访问时位置为字节偏移，多字节字符只计其首字节
+                const bool direct = context.readUnicode.GetDirectData() != nullptr;
+                wchar_t ch;
+                for (size_t pos = 0; (ch = context.readUnicode.getProgmWStr(pos)) != L'\0'; pos++) {
+                    if (!direct || (ch & 0xC0) != 0x80) {
+                        chars++;
+                    }
+                }
+            });
+            PrintRate(backend == BACKEND_STREAM ? L"stream " : L"mapping", chars, L"chars", elapsed, mb);
+            wcout << endl;
+        }
+        context.readUnicode.InitReadUnicode();
+    }
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 分块源程序存储测试
+ * @details 流式后端下完整词法分析大文件，比较全部保留与固定回看窗口
+ *          的吞吐量和存储占用
+ */
+void BenchSourceStore()
+{
+    CompilerContext context;
+    string filename = BENCH_DIR + "bench_store.txt";
+    double mb = PrintSource(GenerateSource(filename, 250000));
+
+    const size_t retentions[] = { RETAIN_ALL, CHUNK_SIZE };
+    for (size_t retention : retentions) {
+        size_t tokens = 0;
+        context.Reset();
+        context.readUnicode.SetRetention(retention);
+        double elapsed = Timed([&]() {
+            context.readUnicode.readFile2USC2(filename, BACKEND_STREAM);
+            tokens = CountTokens(context.lexer);
+        });
+        PrintRate(retention == RETAIN_ALL ? L"full  " : L"window", tokens, L"tokens", elapsed, mb);
+        wcout << L", store " << context.readUnicode.GetRetainedBytes() / 1024 << L" KB" << endl;
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 错误诊断输出测试
+ * @details 生成每10行含一个错误的程序并做语法分析，行数逐级翻倍；
+ *          源码片段经行首索引定位，每个错误的耗时应保持稳定，
+ *          总耗时随错误数线性增长
+ */
+void BenchDiagnostics()
+{
+    CompilerContext context;
+    const size_t sizes[] = { 25000, 50000, 100000 };
+    string filename = BENCH_DIR + "bench_diag.txt";
+    for (size_t lines : sizes) {
+        GenerateSource(filename, lines, false, 10);
+        double elapsed = TimeCompile(context, filename);
+        unsigned int errors = context.errorHandle.GetErrorCount();
+        wcout << L"  " << setw(6) << lines << L" lines: " << setw(6) << errors << L" errors, "
+              << fixed << setprecision(3) << elapsed * 1000 << L" ms, "
+              << setprecision(2) << elapsed * 1e6 / errors << L" us/error" << endl;
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 线性查找保留字(原Reserve的实现，作为对照)
+ * @param word 单词
+ * @return 保留字对应的词法单元类型，不是保留字时返回IDENT
+ * @details 逐项整串比较保留字表，再将下标映射为词法单元类型
+ */
+unsigned long LinearKeyword(const wstring& word)
+{
+    static const wstring table[RSV_WORD_MAX] = {
+        L"odd", L"begin", L"end", L"if", L"then", L"while", L"do", L"call",
+        L"const", L"var", L"procedure", L"write", L"read", L"program", L"else"
+    };
+    static const unsigned long types[RSV_WORD_MAX] = {
+        ODD_SYM, BEGIN_SYM, END_SYM, IF_SYM, THEN_SYM, WHILE_SYM, DO_SYM, CALL_SYM,
+        CONST_SYM, VAR_SYM, PROC_SYM, WRITE_SYM, READ_SYM, PROGM_SYM, ELSE_SYM
+    };
+    for (int i = 0; i < RSV_WORD_MAX; i++) {
+        if (table[i] == word) {
+            return types[i];
+        }
+    }
+    return IDENT;
+}
+
+/**
+ * @brief 保留字查找测试
+ * @details 以标识符为主(约七成)、夹杂保留字的单词序列反复查找，
+ *          比较线性整串比较与完美哈希的耗时
+ */
+void BenchKeywords()
+{
+    static const wchar_t* keywords[] = {
+        L"begin", L"end", L"if", L"then", L"while", L"do", L"call", L"var", L"write", L"read"
+    };
+    const size_t wordCnt = 20000;
+    const int rounds = 200;
+
+    // 生成单词序列(固定种子，结果可复现)
+    vector<wstring> words;
+    words.reserve(wordCnt);
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < wordCnt; i++) {
+        seed = seed * 1103515245 + 12345;
+        if ((seed >> 16) % 10 < 3) {
+            words.push_back(keywords[(seed >> 8) % 10]);
+            continue;
+        }
+        wstring word;
+        size_t length = 1 + (seed >> 12) % 10;
+        for (size_t j = 0; j < length; j++) {
+            seed = seed * 1103515245 + 12345;
+            word += static_cast<wchar_t>(j > 0 && (seed >> 16) % 4 == 0 ? L'0' + (seed >> 8) % 10 : L'a' + (seed >> 8) % 26);
+        }
+        words.push_back(word);
+    }
+
+    // 累计识别出的保留字数，避免查找被优化掉
+    size_t linearHits = 0, hashHits = 0;
+    double linear = Timed([&]() {
+        for (int r = 0; r < rounds; r++) {
+            for (const wstring& word : words) {
+                linearHits += LinearKeyword(word) != IDENT;
+            }
+        }
+    });
+    double hashed = Timed([&]() {
+        for (int r = 0; r < rounds; r++) {
+            for (const wstring& word : words) {
+                hashHits += LookupKeyword(word.data(), word.length()) != IDENT;
+            }
+        }
+    });
+
+    double lookups = static_cast<double>(wordCnt) * rounds;
+    wcout << L"  单词数: " << wordCnt << L" x " << rounds << L" 轮, 其中保留字 " << hashHits / rounds << L" 个" << endl;
+    wcout << L"  linear : " << fixed << setprecision(2) << linear * 1e9 / lookups << L" ns/lookup ("
+          << linearHits / rounds << L" 个保留字)" << endl;
+    wcout << L"  hash   : " << fixed << setprecision(2) << hashed * 1e9 / lookups << L" ns/lookup" << endl;
+    wcout << L"  加速比 : " << setprecision(1) << linear / hashed << L"x" << endl;
+}
+
+/**
+ * @brief 词法扫描方式测试
+ * @details 内存映射的纯ASCII文件上分别以逐字符分支与DFA方式完整词法分析，
+ *          报告吞吐量
+ */
+void BenchScanner()
+{
+    CompilerContext context;
+    string filename = BENCH_DIR + "bench_scanner.txt";
+    double mb = PrintSource(GenerateSource(filename, 250000));
+
+    const ScanMode modes[] = { SCAN_CLASSIC, SCAN_DFA };
+    for (ScanMode mode : modes) {
+        size_t tokens = 0;
+        context.lexer.SetScanMode(mode);
+        OpenSilently(context, filename);
+        double elapsed = Timed([&]() { tokens = CountTokens(context.lexer); });
+        PrintRate(mode == SCAN_CLASSIC ? L"classic" : L"dfa    ", tokens, L"tokens", elapsed, mb);
+        wcout << endl;
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 完整语法分析文件并报告耗时与词法单元序列占用
+ * @param context 编译上下文，各项模式由调用者事先设置
+ * @param filename 源文件路径
+ * @param name 输出时显示的名称
+ * @param mb 文件大小(MB)
+ */
+static void MeasureParse(CompilerContext& context, const string& filename, const wchar_t* name, double mb)
+{
+    double elapsed = TimeCompile(context, filename);
+    PrintRate(name, context.pcodelist.code_list.size(), L"codes", elapsed, mb);
+    wcout << L", tokens " << context.lexer.GetTokens().capacity() * sizeof(Token) / 1024 << L" KB" << endl;
+}
+
+/**
+ * @brief 词法单元序列测试
+ * @details 分别以边扫描边分析、先整体词法分析再消费词法单元序列两种方式
+ *          完整语法分析同一文件
+ */
+void BenchTokenStream()
+{
+    CompilerContext context;
+    string filename = BENCH_DIR + "bench_tokens.txt";
+    double mb = PrintSource(GenerateSource(filename, 250000));
+
+    context.parser.SetTokenizeAll(false);
+    MeasureParse(context, filename, L"streaming", mb);
+    context.parser.SetTokenizeAll(true);
+    MeasureParse(context, filename, L"tokenized", mb);
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 标识符原子表测试
+ * @details 声明数千个变量并逐一赋值，符号表按原子比较名称；
+ *          报告语法分析耗时以及符号表项与原子表的内存占用
+ */
+void BenchAtoms()
+{
+    CompilerContext context;
+    const size_t sizes[] = { 2000, 4000, 8000 };
+    string filename = BENCH_DIR + "bench_atoms.txt";
+    for (size_t symbols : sizes) {
+        GenerateSymbolSource(filename, symbols);
+        double elapsed = TimeCompile(context, filename);
+        size_t items = context.symTable.table.size();
+        wcout << L"  " << setw(5) << symbols << L" symbols: " << fixed << setprecision(3)
+              << elapsed * 1000 << L" ms, table " << items * sizeof(SymTableItem) / 1024
+              << L" KB (" << sizeof(SymTableItem) << L" B/item), atoms " << context.atomTable.Size()
+              << L" / " << context.atomTable.GetMemoryBytes() / 1024 << L" KB" << endl;
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 空行压力测试
+ * @details 程序体中插入一千万个空行，分别以两种扫描方式完整编译并报告耗时
+ */
+void BenchBlankLines()
+{
+    CompilerContext context;
+    const size_t blankLines = 10000000;
+    string filename = BENCH_DIR + "bench_blank.txt";
+    double mb = PrintSource(GenerateBlankSource(filename, blankLines), L", " + to_wstring(blankLines) + L" 个空行");
+
+    const ScanMode modes[] = { SCAN_CLASSIC, SCAN_DFA };
+    for (ScanMode mode : modes) {
+        context.lexer.SetScanMode(mode);
+        double elapsed = TimeCompile(context, filename);
+        PrintRate(mode == SCAN_CLASSIC ? L"classic" : L"dfa    ", context.lexer.GetLineCount(), L"lines", elapsed, mb);
+        wcout << L", " << context.pcodelist.code_list.size() << L" codes, "
+              << context.errorHandle.GetErrorCount() << L" errors" << endl;
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 并行词法分析测试
+ * @details 按行切分源程序，以不同线程数整体词法分析同一文件，报告相对单线程的加速比
+ */
+void BenchParallelLex()
+{
+    CompilerContext context;
+    string filename = BENCH_DIR + "bench_parallel.txt";
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    double mb = PrintSource(GenerateSource(filename, 2000000), L", CPU核数: " + to_wstring(cores));
+
+    double serial = 0;
+    for (unsigned threads = 1; threads <= max(4u, cores); threads *= 2) {
+        OpenSilently(context, filename);
+        double elapsed = Timed([&]() { context.lexer.Tokenize(threads); });
+        if (threads == 1) {
+            serial = elapsed;
+        }
+        PrintRate(to_wstring(threads) + L" threads", context.lexer.GetTokens().size(), L"tokens", elapsed, mb);
+        wcout << L", x" << setprecision(2) << serial / elapsed << endl;
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 词法/语法分析流水线测试
+ * @details 分别以单线程边扫描边分析、词法分析线程经环形队列供给两种方式
+ *          完整语法分析同一文件
+ */
+void BenchPipeline()
+{
+    CompilerContext context;
+    string filename = BENCH_DIR + "bench_pipeline.txt";
+    double mb = PrintSource(GenerateSource(filename, 1000000));
+
+    context.parser.SetPipelined(false);
+    MeasureParse(context, filename, L"streaming", mb);
+    context.parser.SetPipelined(true);
+    MeasureParse(context, filename, L"pipelined", mb);
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 语法树模式测试
+ * @details 分别以直接生成、建立语法树后降级两种方式完整编译同一文件，
+ *          语法树模式另报告节点数与分配区占用
+ */
+void BenchAst()
+{
+    CompilerContext context;
+    string filename = BENCH_DIR + "bench_ast.txt";
+    double mb = PrintSource(GenerateSource(filename, 500000));
+
+    const bool astModes[] = { false, true };
+    for (bool buildAst : astModes) {
+        context.parser.SetBuildAst(buildAst);
+        double elapsed = TimeCompile(context, filename);
+        PrintRate(buildAst ? L"ast   " : L"direct", context.pcodelist.code_list.size(), L"codes", elapsed, mb);
+        if (buildAst) {
+            wcout << L", nodes " << CountAstNodes(context.parser.GetAst()) << L" (" << sizeof(AstNode)
+                  << L" B/node), arena " << context.parser.GetAstArena().GetReservedBytes() / 1024 << L" KB";
+        }
+        wcout << endl;
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 深度嵌套表达式测试
+ * @details 浅嵌套时比较递归下降与显式栈两种表达式分析方式；
+ *          一百万层嵌套只用显式栈分析(递归下降会耗尽调用栈)，比较直接生成与语法树模式
+ */
+void BenchNestedExp()
+{
+    CompilerContext context;
+    string filename = BENCH_DIR + "bench_nested.txt";
+    struct Case { size_t depth; bool recursive; bool buildAst; const wchar_t* name; };
+    const Case cases[] = {
+        { 1000, true, false, L"recursive" }, { 1000, false, false, L"explicit " },
+        { 1000000, false, false, L"explicit " }, { 1000000, false, true, L"ast      " },
+    };
+
+    size_t depth = 0;
+    double mb = 0;
+    for (const Case& item : cases) {
+        if (item.depth != depth) {
+            depth = item.depth;
+            mb = PrintSource(GenerateNestedSource(filename, depth), L", 嵌套" + to_wstring(depth) + L"层");
+        }
+        context.parser.SetRecursiveExp(item.recursive);
+        context.parser.SetBuildAst(item.buildAst);
+        double elapsed = TimeCompile(context, filename);
+        PrintRate(item.name, context.pcodelist.code_list.size(), L"codes", elapsed, mb);
+        wcout << endl;
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 符号查找测试
+ * @details 单层声明大量变量，每条语句查找三个符号；逐层查找沿链比较，总耗时随变量数平方增长，
+ *          名称索引查找应近似线性
+ */
+void BenchSymbolLookup()
+{
+    CompilerContext context;
+    const size_t sizes[] = { 12500, 25000, 50000, 100000 };
+    const size_t chainLimit = 25000;    // 逐层查找只测到此规模
+    string filename = BENCH_DIR + "bench_lookup.txt";
+
+    const bool indexModes[] = { false, true };
+    for (size_t symbols : sizes) {
+        GenerateSymbolSource(filename, symbols);
+        for (bool indexed : indexModes) {
+            if (!indexed && symbols > chainLimit) {
+                continue;
+            }
+            context.symTable.SetIndexed(indexed);
+            double elapsed = TimeCompile(context, filename);
+            wcout << L"  " << (indexed ? L"index" : L"chain") << L" " << setw(6) << symbols << L" symbols: "
+                  << fixed << setprecision(3) << elapsed * 1000 << L" ms, "
+                  << setprecision(1) << elapsed * 1e9 / (symbols * 3) << L" ns/lookup" << endl;
+        }
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 符号信息存储测试
+ * @details 反复编译同一个声明大量变量的程序，报告各轮的耗时、符号信息记录与堆内存占用；
+ *          符号信息记录在线性分配区中，每次编译开始时整体复位
+ */
+void BenchSymbolStore()
+{
+    CompilerContext context;
+    const size_t symbols = 20000;
+    const int rounds = 10;
+    string filename = BENCH_DIR + "bench_symstore.txt";
+    GenerateSymbolSource(filename, symbols);
+
+    for (int round = 1; round <= rounds; round++) {
+        double elapsed = TimeCompile(context, filename);
+        wcout << L"  round " << setw(2) << round << L": " << fixed << setprecision(3) << elapsed * 1000
+              << L" ms, " << context.symTable.table.size() << L" entries, records "
+              << context.symTable.GetInfoBytes() / 1024 << L" KB (" << sizeof(Information)
+              << L" B/record), heap " << context.symTable.GetMemoryBytes() / 1024 << L" KB" << endl;
+    }
+
+    context.readUnicode.InitReadUnicode();
+    remove(filename.c_str());
+}
+
+/**
+ * @brief 多编译上下文并发测试
+ * @details 先用一个上下文依次编译若干不同的程序，再为每个程序各建一个上下文、
+ *          每个线程一个上下文同时编译，报告两种方式的吞吐量
+ */
+void BenchContexts()
+{
+    CompilerContext context;
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    const unsigned programs = max(4u, cores);
+    vector<string> files;
+    size_t bytes = 0;
+    for (unsigned i = 0; i < programs; i++) {
+        files.push_back(BENCH_DIR + "bench_context_" + to_string(i) + ".txt");
+        bytes += GenerateSource(files.back(), 200000 + i * 10000);
+    }
+    double mb = PrintSource(bytes, L", " + to_wstring(programs) + L" 个程序, CPU核数: " + to_wstring(cores));
+
+    double serial = Timed([&]() {
+        for (const string& file : files) {
+            context.Compile(file);
+        }
+    });
+    double concurrent = Timed([&]() {
+        vector<thread> workers;
+        for (const string& file : files) {
+            workers.emplace_back([&file]() {
+                CompilerContext local;
+                local.Compile(file);
+            });
+        }
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    });
+    PrintRate(L"sequential", programs, L"files", serial, mb);
+    wcout << endl;
+    PrintRate(L"concurrent", programs, L"files", concurrent, mb);
+    wcout << L", x" << setprecision(2) << serial / concurrent << endl;
+
+    context.readUnicode.InitReadUnicode();
+    for (const string& file : files) {
+        remove(file.c_str());
+    }
+}
+
+/**
+ * @brief 批量编译测试
+ * @details 生成大量长短不一、部分含错误的程序，以不同线程数批量编译，
+ *          报告吞吐量、窃取次数与相对单线程的加速比
+ */
+void BenchBatch()
+{
+    const size_t programs = 2000;
+    vector<string> files;
+    for (size_t i = 0; i < programs; i++) {
+        files.push_back(BENCH_DIR + "bench_batch_" + to_string(i) + ".txt");
+        GenerateSource(files.back(), 20 + (i * 7919) % 2000, false, i % 10 == 0 ? 50 : 0);
+    }
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    wcout << L"测试文件: " << programs << L" 个, CPU核数: " << cores << endl;
+
+    double serial = 0;
+    for (unsigned threads = 1; threads <= max(4u, cores); threads *= 2) {
+        BatchOptions options;
+        options.threads = threads;
+        vector<BatchResult> results;
+        BatchStats stats = CompileBatch(files, options, results);
+        if (threads == 1) {
+            serial = stats.seconds;
+        }
+        wcout << L"  " << setw(2) << threads << L" threads: " << fixed << setprecision(3) << stats.seconds * 1000
+              << L" ms, " << setprecision(0) << stats.files / stats.seconds << L" files/s, "
+              << stats.lines / stats.seconds << L" lines/s, " << stats.failed << L" failed, "
+              << stats.steals << L" steals, x" << setprecision(2) << serial / stats.seconds << endl;
+    }
+
+    for (const string& file : files) {
+        remove(file.c_str());
+    }
+}
+
+/**
+ * @brief 窥孔优化测试
+ * @details 对test目录下可运行的示例程序，比较优化前后的指令条数与重复解释执行的耗时
+ */
+void BenchPeephole()
+{
+    CompilerContext context;
+    static const char* programs[] = {
+        "factorial.txt", "fibonacci.txt", "recursive-factorial.txt", "z=x+y.txt", "pcode.txt",
+    };
+    const int rounds = 20000;
+    for (const char* program : programs) {
+        if (!Prepare(context, BENCH_DIR + program)) {
+            continue;
+        }
+        size_t before = context.pcodelist.code_list.size();
+        double plain = TimeRuns(context, rounds);
+        Prepare(context, BENCH_DIR + program, 1);
+        size_t after = context.pcodelist.code_list.size();
+        double optimized = TimeRuns(context, rounds);
+        wcout << L"  " << left << setw(24) << program << right << setw(4) << before << L" -> " << setw(4) << after
+              << L" codes, " << fixed << setprecision(3) << plain * 1000 << L" ms -> " << optimized * 1000
+              << L" ms, x" << setprecision(2) << plain / optimized << endl;
+    }
+}
+
+/**
+ * @brief 常量折叠测试
+ * @details 对test目录下的示例程序与生成的常量密集程序，比较折叠前后的指令条数与解释执行耗时
+ */
+void BenchFold()
+{
+    CompilerContext context;
+    string generated = BENCH_DIR + "bench_fold.txt";
+    GenerateConstantSource(generated, 64);
+    const string programs[] = {
+        BENCH_DIR + "factorial.txt", BENCH_DIR + "fibonacci.txt", BENCH_DIR + "recursive-factorial.txt",
+        BENCH_DIR + "z=x+y.txt", generated,
+    };
+    const int rounds = 20;
+    for (const string& program : programs) {
+        context.parser.SetFoldConstants(false);
+        if (!Prepare(context, program)) {
+            continue;
+        }
+        size_t before = context.pcodelist.code_list.size();
+        double plain = TimeRuns(context, rounds);
+        context.parser.SetFoldConstants(true);
+        Prepare(context, program);
+        size_t after = context.pcodelist.code_list.size();
+        double folded = TimeRuns(context, rounds);
+        wcout << L"  " << left << setw(24) << program.substr(BENCH_DIR.size()).c_str() << right << setw(5) << before
+              << L" -> " << setw(5) << after << L" codes, " << fixed << setprecision(3) << plain * 1000 << L" ms -> "
+              << folded * 1000 << L" ms, x" << setprecision(2) << plain / folded << endl;
+    }
+    context.readUnicode.InitReadUnicode();
+    remove(generated.c_str());
+}
+
+/**
+ * @brief 超级指令测试
+ * @details fibonacci.txt的循环次数放大到十万次，recursive-factorial.txt输入放大到递归一万层；
+ *          分别统计原始、窥孔优化后、再合并超级指令后的指令条数、分派次数与耗时
+ */
+void BenchSuper()
+{
+    CompilerContext context;
+    string scaled = BENCH_DIR + "bench_fibonacci.txt";
+    {
+        ifstream in(BENCH_DIR + "fibonacci.txt", ios::binary);
+        string source((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        size_t pos = source.find("max := 10");
+        if (pos != string::npos) {
+            source.replace(pos, 9, "max := 100000");
+        }
+        ofstream out(scaled, ios::binary);
+        out << source;
+    }
+    struct Case { string file; wstring input; const wchar_t* name; int rounds; };
+    const Case cases[] = {
+        { scaled, L"", L"fibonacci x10000", 10 },
+        { BENCH_DIR + "recursive-factorial.txt", L"10000", L"recursive-factorial(10000)", 100 },
+    };
+    static const wchar_t* stages[] = { L"plain", L"peephole", L"+super" };
+
+    for (const Case& item : cases) {
+        wcout << item.name << L":" << endl;
+        for (int stage = 0; stage < 3; stage++) {
+            if (!Prepare(context, item.file, stage)) {
+                break;
+            }
+            size_t codes = context.pcodelist.code_list.size();
+            double elapsed = TimeRuns(context, item.rounds, item.input);
+            size_t dispatched = context.interpreter.dispatched;
+            wcout << L"  " << left << setw(10) << stages[stage] << right << setw(4) << codes << L" codes, "
+                  << setw(10) << dispatched << L" dispatched, " << fixed << setprecision(3)
+                  << elapsed * 1000 / item.rounds << L" ms/run, " << setprecision(1)
+                  << elapsed * 1e9 / item.rounds / dispatched << L" ns/dispatch" << endl;
+        }
+    }
+    context.readUnicode.InitReadUnicode();
+    remove(scaled.c_str());
+}
+
+/**
+ * @brief 直接线索化执行测试
+ * @details 以循环为主的生成程序与放大后的recursive-factorial.txt，比较逐条解释(switch + 成员函数)
+ *          与直接线索化执行的每条指令耗时，各自在原始指令与超级指令上测量。
+ *          同一台机器上每条指令耗时之比即每条指令周期数之比
+ */
+void BenchThreaded()
+{
+    CompilerContext context;
+    string generated = BENCH_DIR + "bench_loop.txt";
+    GenerateLoopSource(generated, 2000);
+    struct Case { string file; wstring input; const wchar_t* name; int rounds; };
+    const Case cases[] = {
+        { generated, L"", L"loop 2000x100", 5 },
+        { BENCH_DIR + "recursive-factorial.txt", L"10000", L"recursive-factorial(10000)", 200 },
+    };
+
+    for (const Case& item : cases) {
+        wcout << item.name << L":" << endl;
+        for (int fused = 0; fused < 2; fused++) {
+            double perInst[2];
+            for (int threaded = 0; threaded < 2; threaded++) {
+                if (!Prepare(context, item.file, fused ? 2 : 0)) {
+                    break;
+                }
+                context.interpreter.SetThreaded(threaded);
+                double elapsed = TimeRuns(context, item.rounds, item.input);
+                size_t dispatched = context.interpreter.dispatched;
+                context.interpreter.SetThreaded(false);
+                perInst[threaded] = elapsed * 1e9 / item.rounds / dispatched;
+                wcout << L"  " << left << setw(8) << (fused ? L"super" : L"plain") << setw(10)
+                      << (threaded ? L"threaded" : L"switch") << right << setw(10) << dispatched << L" dispatched, "
+                      << fixed << setprecision(3) << elapsed * 1000 / item.rounds << L" ms/run, "
+                      << setprecision(2) << perInst[threaded] << L" ns/inst";
+                if (threaded) {
+                    wcout << L", x" << perInst[0] / perInst[1];
+                }
+                wcout << endl;
+            }
+        }
+    }
+    context.readUnicode.InitReadUnicode();
+    remove(generated.c_str());
+}
+
+/**
+ * @brief 固定容量运行时栈测试
+ * @details 在直接线索化执行下比较按需扩展的运行时栈与预先分配的固定容量栈(堆上/保护页/大页)，
+ *          按需扩展的栈每次运行前清空以计入扩展的开销
+ */
+void BenchFixedStack()
+{
+    CompilerContext context;
+    string generated = BENCH_DIR + "bench_loop.txt";
+    GenerateLoopSource(generated, 500);
+    struct Case { string file; wstring input; const wchar_t* name; int rounds; };
+    const Case cases[] = {
+        { generated, L"", L"loop 500x100", 10 },
+        { BENCH_DIR + "recursive-factorial.txt", L"100000", L"recursive-factorial(100000)", 50 },
+    };
+    struct Mode { const wchar_t* name; unsigned flags; bool fixed; };
+    const Mode modes[] = {
+        { L"growable", 0, false }, { L"fixed", 0, true },
+        { L"guard", STACK_GUARD, true }, { L"huge pages", STACK_HUGE_PAGES, true },
+    };
+    const size_t cells = 4 * VM_STACK_DEFAULT;
+    Interpreter& interpreter = context.interpreter;
+
+    for (const Case& item : cases) {
+        wcout << item.name << L":" << endl;
+        for (const Mode& mode : modes) {
+            if (!Prepare(context, item.file)) {
+                break;
+            }
+            interpreter.SetThreaded(true);
+            if (mode.fixed) {
+                interpreter.SetFixedStack(cells, mode.flags);
+            }
+            double elapsed = TimeRuns(context, item.rounds, item.input, !mode.fixed);
+            unsigned effective = interpreter.GetFixedStack().Flags();
+            wcout << L"  " << left << setw(12) << mode.name << right << fixed << setprecision(3)
+                  << elapsed * 1000 / item.rounds << L" ms/run";
+            if (mode.fixed) {
+                wcout << L", " << interpreter.GetFixedStack().Capacity() << L" cells"
+                      << ((effective & STACK_GUARD) ? L", guard page" : L"")
+                      << ((effective & STACK_HUGE_PAGES) ? L", huge pages" : L"")
+                      << ((mode.flags & STACK_HUGE_PAGES) && !(effective & STACK_HUGE_PAGES) ? L" (大页不可用，已退回普通页)" : L"");
+            }
+            wcout << endl;
+            interpreter.SetFixedStack(0);
+            interpreter.SetThreaded(false);
+        }
+    }
+    context.readUnicode.InitReadUnicode();
+    remove(generated.c_str());
+}
+
+/**
+ * @brief 栈深度分析测试
+ * @details 先列出各程序的过程数与分析得到的栈容量；再比较按分析结果确定容量的固定栈与默认容量的固定栈，
+ *          以及按需扩展的栈在INT处逐单元扩展(清除分析结果)与一次扩展到整个活动记录的耗时。
+ *          按需扩展的栈每次运行前清空以计入扩展的开销
+ */
+void BenchFrames()
+{
+    CompilerContext context;
+    string generated = BENCH_DIR + "bench_loop.txt";
+    GenerateLoopSource(generated, 500);
+    struct Case { string file; wstring input; const wchar_t* name; int rounds; };
+    const Case cases[] = {
+        { generated, L"", L"loop 500x100", 10 },
+        { BENCH_DIR + "fibonacci.txt", L"", L"fibonacci", 20000 },
+        { BENCH_DIR + "recursive-factorial.txt", L"100000", L"recursive-factorial(100000)", 50 },
+    };
+    static const wchar_t* names[] = { L"fixed default", L"fixed analyzed", L"grow per cell", L"grow frame" };
+    Interpreter& interpreter = context.interpreter;
+    // 清除分析结果，INT退回只分配活动记录本身
+    auto forget = [&]() {
+        for (PCode& code : context.pcodelist.code_list) {
+            if (code.op == alloc) {
+                code.b = 0;
+            }
+        }
+        context.pcodelist.frames.clear();
+        context.pcodelist.stackBound = 0;
+    };
+
+    for (const Case& item : cases) {
+        if (!Prepare(context, item.file)) {
+            continue;
+        }
+        size_t bound = context.pcodelist.stackBound;
+        wcout << item.name << L": " << context.pcodelist.frames.size() << L" procedures, stack bound ";
+        if (bound > 0) {
+            wcout << bound << L" cells" << endl;
+        }
+        else {
+            wcout << L"unknown (recursive)" << endl;
+        }
+
+        for (int mode = 0; mode < 4; mode++) {
+            if (mode == 1 && bound == 0) {
+                continue;
+            }
+            Prepare(context, item.file);
+            if (mode == 2) {
+                forget();
+            }
+            interpreter.SetThreaded(true);
+            if (mode < 2) {
+                interpreter.SetFixedStack(mode == 1 ? bound : VM_STACK_DEFAULT);
+            }
+            double elapsed = TimeRuns(context, item.rounds, item.input, mode >= 2);
+            wcout << L"  " << left << setw(16) << names[mode] << right << fixed << setprecision(4)
+                  << elapsed * 1000 / item.rounds << L" ms/run";
+            if (mode < 2) {
+                wcout << L", " << interpreter.GetFixedStack().Capacity() << L" cells";
+            }
+            wcout << endl;
+            interpreter.SetFixedStack(0);
+            interpreter.SetThreaded(false);
+        }
+    }
+    context.readUnicode.InitReadUnicode();
+    remove(generated.c_str());
+}
+
+/**
+ * @brief 性能测试菜单
+ */
+void RunBenchmark()
+{
+    wcout << L"=== 性能测试 ===" << endl;
+    wcout << L"1. 源文件读取后端 (stream / mapping)" << endl;
+    wcout << L"2. 分块源程序存储 (全部保留 / 回看窗口)" << endl;
+    wcout << L"3. 错误诊断输出 (行首索引)" << endl;
+    wcout << L"4. 保留字查找 (线性 / 完美哈希)" << endl;
+    wcout << L"5. 词法扫描方式 (逐字符分支 / DFA)" << endl;
+    wcout << L"6. 词法单元序列 (边扫描边分析 / 整体词法分析)" << endl;
+    wcout << L"7. 标识符原子表 (符号查找与内存)" << endl;
+    wcout << L"8. 空行压力测试 (一千万空行)" << endl;
+    wcout << L"9. 并行词法分析 (按行切分多线程扫描)" << endl;
+    wcout << L"10. 词法/语法分析流水线 (单线程 / 双线程)" << endl;
+    wcout << L"11. 语法树模式 (直接生成 / 语法树降级)" << endl;
+    wcout << L"12. 深度嵌套表达式 (递归下降 / 显式栈)" << endl;
+    wcout << L"13. 符号查找 (逐层查找 / 名称索引)" << endl;
+    wcout << L"14. 符号信息存储 (重复编译的堆内存)" << endl;
+    wcout << L"15. 多编译上下文并发 (顺序 / 每线程一个上下文)" << endl;
+    wcout << L"16. 批量编译 (工作窃取线程池)" << endl;
+    wcout << L"17. 窥孔优化 (指令条数与解释执行耗时)" << endl;
+    wcout << L"18. 常量折叠 (指令条数与解释执行耗时)" << endl;
+    wcout << L"19. 超级指令 (分派次数与解释执行耗时)" << endl;
+    wcout << L"20. 直接线索化执行 (switch / computed goto)" << endl;
+    wcout << L"21. 固定容量运行时栈 (按需扩展 / 预先分配)" << endl;
+    wcout << L"22. 栈深度分析 (固定栈容量与一次分配活动记录)" << endl;
+    wcout << L"请选择测试项: ";
+
+    int choice = -1;
+    cin >> choice;
+    switch (choice)
+    {
+    case 1:
+        BenchReader();
+        break;
+    case 2:
+        BenchSourceStore();
+        break;
+    case 3:
+        BenchDiagnostics();
+        break;
+    case 4:
+        BenchKeywords();
+        break;
+    case 5:
+        BenchScanner();
+        break;
+    case 6:
+        BenchTokenStream();
+        break;
+    case 7:
+        BenchAtoms();
+        break;
+    case 8:
+        BenchBlankLines();
+        break;
+    case 9:
+        BenchParallelLex();
+        break;
+    case 10:
+        BenchPipeline();
+        break;
+    case 11:
+        BenchAst();
+        break;
+    case 12:
+        BenchNestedExp();
+        break;
+    case 13:
+        BenchSymbolLookup();
+        break;
+    case 14:
+        BenchSymbolStore();
+        break;
+    case 15:
+        BenchContexts();
+        break;
+    case 16:
+        BenchBatch();
+        break;
+    case 17:
+        BenchPeephole();
+        break;
+    case 18:
+        BenchFold();
+        break;
+    case 19:
+        BenchSuper();
+        break;
+    case 20:
+        BenchThreaded();
+        break;
+    case 21:
+        BenchFixedStack();
+        break;
+    case 22:
+        BenchFrames();
+        break;
+    default:
+        wcout << L"无效选项" << endl;
+        break;
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file Compiler.cpp
+ * @brief 编译上下文实现
+ */
+
+#include <Compiler.hpp>
+
+/**
+ * @brief 构造编译上下文并绑定各模块
+ * @details 错误处理器先于词法分析器构造，此时只绑定其引用，构造期间不访问
+ */
+CompilerContext::CompilerContext()
+    : errorHandle(lexer, readUnicode),
+      lexer(readUnicode, errorHandle, atomTable),
+      symTable(lexer, errorHandle, atomTable),
+      parser(lexer, symTable, errorHandle, pcodelist, atomTable),
+      interpreter(pcodelist)
+{
+}
+
+/**
+ * @brief 复位各模块，准备下一次编译
+ */
+void CompilerContext::Reset()
+{
+    readUnicode.InitReadUnicode();
+    lexer.InitLexer();
+    errorHandle.InitErrorHandle();
+    symTable.InitAndClear();
+    pcodelist.clear();
+}
+
+/**
+ * @brief 复位并打开源文件
+ * @param filename 源文件路径
+ * @param mode 读取后端
+ * @return 文件打开成功且非空返回true
+ */
+bool CompilerContext::Open(const string& filename, SourceBackend mode)
+{
+    Reset();
+    readUnicode.readFile2USC2(filename, mode);
+    return !readUnicode.isEmpty();
+}
+
+/**
+ * @brief 分析已打开的源程序并生成P-Code
+ * @return 没有错误返回true
+ * @details 编译成功后随即分析各过程的栈使用
+ */
+bool CompilerContext::Compile()
+{
+    parser.analyze();
+    if (errorHandle.GetErrorCount() != 0) {
+        return false;
+    }
+    AnalyzeFrames(pcodelist);
+    return true;
+}
+
+/**
+ * @brief 打开并分析源文件
+ * @param filename 源文件路径
+ * @return 文件打开成功且没有错误返回true
+ */
+bool CompilerContext::Compile(const string& filename)
+{
+    return Open(filename) && Compile();
+}
+
+/**
+ * @brief 窥孔优化生成的P-Code
+ * @param rules 启用的规则(PEEP_*)
+ * @return 优化统计
+ * @details 应在编译成功后调用，改写后重新分析栈使用
+ */
+PeepholeStats CompilerContext::Optimize(unsigned rules)
+{
+    PeepholeStats stats = PeepholeOptimize(pcodelist, rules);
+    AnalyzeFrames(pcodelist);
+    return stats;
+}
+
+/**
+ * @brief 合并超级指令
+ * @return 合并统计
+ * @details 应在窥孔优化之后调用，改写后重新分析栈使用
+ */
+PeepholeStats CompilerContext::Fuse()
+{
+    PeepholeStats stats = FuseSuperinstructions(pcodelist);
+    AnalyzeFrames(pcodelist);
+    return stats;
+}
+
+/**
+ * @brief 解释执行生成的P-Code
+ */
+void CompilerContext::Run()
+{
+    interpreter.run();
+}
@@ -0,0 +1,360 @@
+/**
+ * @file Driver.cpp
+ * @brief 命令行驱动实现
+ */
+
+#include <Driver.hpp>
+#include <Compiler.hpp>
+
+/**
+ * @brief 读取进程内存计数
+ * @param peak 输出峰值工作集字节数
+ * @return 当前工作集字节数
+ */
+static size_t QueryMemory(size_t& peak)
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    counters.cb = sizeof(counters);
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        peak = 0;
+        return 0;
+    }
+    peak = counters.PeakWorkingSetSize;
+    return counters.WorkingSetSize;
+}
+
+/**
+ * @brief 开始计量一个阶段
+ */
+void TimeReport::Begin()
+{
+    size_t peak;
+    startBytes = QueryMemory(peak);
+    start = chrono::steady_clock::now();
+}
+
+/**
+ * @brief 结束计量并记入指定阶段
+ * @param phase 阶段
+ */
+void TimeReport::End(DriverPhase phase)
+{
+    PhaseRecord& record = phases[phase];
+    record.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    size_t current = QueryMemory(record.peakBytes);
+    record.deltaBytes = (long long)current - (long long)startBytes;
+    record.ran = true;
+}
+
+/**
+ * @brief 输出各阶段耗时与内存报告
+ * @details 格式仿照-ftime-report，未执行的阶段不列出
+ */
+void TimeReport::Print()
+{
+    static const wchar_t* names[PHASE_CNT] = { L"read", L"lex", L"parse+codegen", L"optimize", L"execute" };
+    double total = 0;
+    size_t peak = 0;
+    for (const PhaseRecord& record : phases) {
+        total += record.seconds;
+        peak = max(peak, record.peakBytes);
+    }
+
+    wcout << L"===-------------------------------------------------------------------===" << endl;
+    wcout << L"                          各阶段耗时与内存报告" << endl;
+    wcout << L"===-------------------------------------------------------------------===" << endl;
+    wcout << L"  " << left << setw(16) << L"phase" << right << setw(12) << L"wall(ms)" << setw(9) << L"%"
+          << setw(14) << L"peak(KB)" << setw(14) << L"delta(KB)" << endl;
+    for (int i = 0; i < PHASE_CNT; i++) {
+        const PhaseRecord& record = phases[i];
+        if (!record.ran) {
+            continue;
+        }
+        wcout << L"  " << left << setw(16) << names[i] << right << fixed
+              << setw(12) << setprecision(3) << record.seconds * 1000
+              << setw(8) << setprecision(1) << (total > 0 ? record.seconds / total * 100 : 0) << L"%"
+              << setw(14) << record.peakBytes / 1024
+              << setw(14) << showpos << record.deltaBytes / 1024 << noshowpos << endl;
+    }
+    wcout << L"  " << left << setw(16) << L"total" << right << fixed
+          << setw(12) << setprecision(3) << total * 1000 << setw(8) << setprecision(1) << 100.0 << L"%"
+          << setw(14) << peak / 1024 << endl;
+}
+
+/**
+ * @brief 输出用法
+ */
+void PrintUsage()
+{
+    wcout << L"用法: compiler <源文件> [选项]" << endl;
+    wcout << L"  --phase=<lex|parse|run>  执行到指定阶段为止(默认run)" << endl;
+    wcout << L"  --dump-pcode             输出生成的P-Code" << endl;
+    wcout << L"  --dump-symtab            输出符号表" << endl;
+    wcout << L"  --dump-frames            输出各过程的活动记录大小与最大栈深度" << endl;
+    wcout << L"  --input=<文件>           程序运行时从该文件读取输入" << endl;
+    wcout << L"  --ast                    经语法树生成P-Code" << endl;
+    wcout << L"  -O                       启用常量折叠、全部窥孔优化与超级指令" << endl;
+    wcout << L"  --fold                   折叠常量表达式，删除恒真/恒假条件的死分支" << endl;
+    wcout << L"  --peephole=<规则,...>    启用指定窥孔优化: jumps, next, dead, negate, identity, loadstore, all" << endl;
+    wcout << L"  --super                  合并常见指令序列为超级指令" << endl;
+    wcout << L"  --threaded               使用直接线索化执行(预译码 + computed goto)" << endl;
+    wcout << L"  --stack=<单元数>         预先分配固定容量的运行时栈，溢出时报告运行时错误" << endl;
+    wcout << L"  --stack=auto             固定栈容量取静态分析的结果，递归程序取默认容量" << endl;
+    wcout << L"  --stack-guard            固定栈由VirtualAlloc映射(容量取整到页)，末尾设置保护页兜底" << endl;
+    wcout << L"  --huge-pages             固定栈尝试使用大页" << endl;
+    wcout << L"  -ftime-report            输出各阶段耗时与峰值内存" << endl;
+    wcout << L"  -v, --verbose            输出读取过程信息" << endl;
+    wcout << L"  -h, --help               输出本帮助" << endl;
+    wcout << L"不带参数运行时进入交互菜单" << endl;
+}
+
+/**
+ * @brief 解析命令行参数
+ * @param argc 参数个数
+ * @param argv 参数列表
+ * @param options 输出解析结果
+ * @return 参数合法返回true；请求帮助或参数有误返回false
+ */
+bool ParseArguments(int argc, char** argv, DriverOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            return false;
+        }
+        else if (arg == "--phase=lex") {
+            options.stop = PHASE_LEX;
+        }
+        else if (arg == "--phase=parse") {
+            options.stop = PHASE_PARSE;
+        }
+        else if (arg == "--phase=run") {
+            options.stop = PHASE_RUN;
+        }
+        else if (arg == "--dump-pcode") {
+            options.dumpPCode = true;
+        }
+        else if (arg == "--dump-symtab") {
+            options.dumpSymTab = true;
+        }
+        else if (arg == "--dump-frames") {
+            options.dumpFrames = true;
+        }
+        else if (arg.compare(0, 8, "--input=") == 0) {
+            options.input = arg.substr(8);
+        }
+        else if (arg == "--ast") {
+            options.buildAst = true;
+        }
+        else if (arg == "-O") {
+            options.foldConstants = true;
+            options.peephole = PEEP_ALL;
+            options.superinstructions = true;
+        }
+        else if (arg == "--super") {
+            options.superinstructions = true;
+        }
+        else if (arg == "--threaded") {
+            options.threaded = true;
+        }
+        else if (arg == "--stack=auto") {
+            options.stackAuto = true;
+        }
+        else if (arg.compare(0, 8, "--stack=") == 0) {
+            char* end;
+            options.stackCells = strtoull(arg.c_str() + 8, &end, 10);
+            if (*end != '\0' || options.stackCells == 0) {
+                wcout << L"[Error] 无效的栈容量: " << argv[i] << endl;
+                return false;
+            }
+        }
+        else if (arg == "--stack-guard") {
+            options.stackFlags |= STACK_GUARD;
+        }
+        else if (arg == "--huge-pages") {
+            options.stackFlags |= STACK_HUGE_PAGES;
+        }
+        else if (arg == "--fold") {
+            options.foldConstants = true;
+        }
+        else if (arg.compare(0, 11, "--peephole=") == 0) {
+            if (!ParsePeepholeRules(arg.substr(11), options.peephole)) {
+                wcout << L"[Error] 无法识别的优化规则: " << argv[i] << endl;
+                return false;
+            }
+        }
+        else if (arg == "-ftime-report") {
+            options.timeReport = true;
+        }
+        else if (arg == "-v" || arg == "--verbose") {
+            options.verbose = true;
+        }
+        else if (arg[0] == '-' || !options.source.empty()) {
+            wcout << L"[Error] 无法识别的参数: " << argv[i] << endl;
+            return false;
+        }
+        else {
+            options.source = arg;
+        }
+    }
+    if (options.source.empty()) {
+        wcout << L"[Error] 未指定源文件" << endl;
+        return false;
+    }
+    if (options.stackFlags && options.stackCells == 0) {
+        options.stackAuto = true;
+    }
+    return true;
+}
+
+/**
+ * @brief 按选项编译并执行
+ * @param options 命令行选项
+ * @return 退出码: 0成功，1源程序有错误，2文件无法打开，3运行时栈溢出
+ * @details 先整体词法分析再语法分析，使词法与语法分析的耗时可以分开计量；
+ *          词法错误在语法分析回放时报告
+ */
+int RunDriver(const DriverOptions& options)
+{
+    CompilerContext context;
+    wostream discard(nullptr);
+    if (!options.verbose) {
+        context.readUnicode.SetLog(discard);
+    }
+    context.parser.SetBuildAst(options.buildAst);
+    context.parser.SetFoldConstants(options.foldConstants);
+    context.interpreter.SetThreaded(options.threaded);
+    TimeReport report;
+    int status = 0;
+
+    report.Begin();
+    bool opened = context.Open(options.source);
+    report.End(PHASE_READ);
+    if (!opened) {
+        wcout << L"[Error] 文件打开失败: " << options.source.c_str() << endl;
+        return 2;
+    }
+    context.errorHandle.SetFileName(wstring(options.source.begin(), options.source.end()));
+
+    report.Begin();
+    context.lexer.Tokenize();
+    report.End(PHASE_LEX);
+
+    if (options.stop == PHASE_LEX) {
+        // 回放全部词法单元以报告词法错误
+        context.lexer.GetWord();
+        while (context.lexer.GetCh() != L'\0') {
+            context.lexer.GetWord();
+        }
+        wcout << L"[Info] " << context.lexer.GetTokens().size() << L" tokens" << endl;
+        context.errorHandle.printSummary();
+        status = context.errorHandle.GetErrorCount() == 0 ? 0 : 1;
+    }
+    else {
+        report.Begin();
+        bool succeeded = context.Compile();
+        report.End(PHASE_PARSE);
+
+        if (succeeded && (options.peephole || options.superinstructions)) {
+            report.Begin();
+            PeepholeStats stats, fused;
+            if (options.peephole) {
+                stats = context.Optimize(options.peephole);
+            }
+            if (options.superinstructions) {
+                fused = context.Fuse();
+            }
+            report.End(PHASE_OPTIMIZE);
+            if (options.peephole) {
+                wcout << L"[Info] peephole: " << stats.before << L" -> " << stats.after << L" codes ("
+                      << stats.retargeted << L" retargeted, " << stats.rewritten << L" rewritten, "
+                      << stats.removed << L" removed, " << stats.passes << L" passes)" << endl;
+            }
+            if (options.superinstructions) {
+                wcout << L"[Info] superinstructions: " << fused.before << L" -> " << fused.after << L" codes ("
+                      << fused.rewritten << L" fused)" << endl;
+            }
+        }
+
+        if (options.dumpSymTab) {
+            context.symTable.showAll();
+        }
+        if (options.dumpPCode) {
+            context.pcodelist.show();
+        }
+        if (options.dumpFrames && succeeded) {
+            context.pcodelist.showFrames();
+        }
+
+        if (!succeeded) {
+            status = 1;
+        }
+        else if (options.stop == PHASE_RUN) {
+            wifstream input;
+            if (!options.input.empty()) {
+                input.open(options.input);
+                if (!input) {
+                    wcout << L"[Error] 输入文件打开失败: " << options.input.c_str() << endl;
+                    return 2;
+                }
+                context.interpreter.SetIO(input, wcout);
+            }
+            // 固定栈在优化之后申请，容量可以取最终指令序列的分析结果
+            size_t cells = options.stackCells;
+            if (options.stackAuto) {
+                cells = context.pcodelist.stackBound > 0 ? context.pcodelist.stackBound : VM_STACK_DEFAULT;
+            }
+            if (cells && !context.interpreter.SetFixedStack(cells, options.stackFlags)) {
+                wcout << L"[Error] 运行时栈分配失败: " << cells << L" 个存储单元" << endl;
+                return 2;
+            }
+            if (cells) {
+                // 映射的栈容量取整到页，报告实际可用的单元数
+                VmStack& stack = context.interpreter.GetFixedStack();
+                const wchar_t* source = !options.stackAuto ? L"requested"
+                                      : context.pcodelist.stackBound > 0 ? L"analyzed" : L"default";
+                wcout << L"[Info] stack: " << stack.Capacity() << L" cells (" << source << L" " << cells;
+                if (stack.Capacity() != cells) {
+                    wcout << L", rounded up to whole pages";
+                }
+                if (stack.Flags() & STACK_GUARD) {
+                    wcout << L", guard page";
+                }
+                if (stack.Flags() & STACK_HUGE_PAGES) {
+                    wcout << L", huge pages";
+                }
+                wcout << L")" << endl;
+            }
+            report.Begin();
+            context.Run();
+            report.End(PHASE_RUN);
+            if (options.timeReport) {
+                wcout << L"[Info] " << context.interpreter.dispatched << L" instructions dispatched" << endl;
+            }
+            if (context.interpreter.stackOverflow) {
+                status = 3;
+            }
+        }
+    }
+
+    if (options.timeReport) {
+        report.Print();
+    }
+    return status;
+}
+
+/**
+ * @brief 命令行入口
+ * @param argc 参数个数
+ * @param argv 参数列表
+ * @return 退出码，参数有误时为2
+ */
+int RunCommandLine(int argc, char** argv)
+{
+    DriverOptions options;
+    if (!ParseArguments(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+    return RunDriver(options);
+}
@@ -5,9 +5,7 @@
  */
 
 #include <ErrorHandle.hpp>
-
-// 错误处理器全局实例
-ErrorHandle errorHandle;
+#include <Lexer.hpp>
 
 /* ============================================================
  *                     私有辅助方法
@@ -16,9 +14,13 @@ ErrorHandle errorHandle;
 /**
  * @brief 设置控制台输出颜色
  * @param color 颜色代码
+ * @details 诊断输出到其他流时不改变控制台颜色
  */
 void ErrorHandle::setColor(ConsoleColor color)
 {
+    if (out != &wcout) {
+        return;
+    }
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     SetConsoleTextAttribute(hConsole, color);
 }
@@ -35,19 +37,28 @@ void ErrorHandle::resetColor()
  * @brief 获取源代码的指定行
  * @param lineNum 行号(从1开始)
  * @return 该行的源代码内容
+ * @details 由词法分析器的行首索引直接定位行首；
+ *          请求的行尚未被索引时，从最后一个已知行首向后扫描
  */
 wstring ErrorHandle::getSourceLine(size_t lineNum)
 {
     if (lineNum == 0) return L"";
     
     wstring line = L"";
-    size_t currentLine = 1;
-    size_t pos = 0;
+    size_t currentLine = min(lineNum, lexer.GetLineCount());
+    size_t pos = lexer.GetLineStart(currentLine);
+    const unsigned char* data = readUnicode.GetDirectData();
     
-    // 遍历源程序找到对应行
+    // 从行首(或最后一个已知行首)向后找到对应行
     while (true) {
         wchar_t ch = readUnicode.getProgmWStr(pos);
         if (ch == L'\0' || ch == L'#') break;
+
+        // 直接访问UTF-8源程序时，多字节字符在此展宽
+        size_t bytes = 1;
+        if (ch >= 0x80 && data) {
+            ch = DecodeUtf8(data + pos, bytes);
+        }
         
         if (currentLine == lineNum) {
             if (ch == L'\n') break;
@@ -56,7 +67,7 @@ wstring ErrorHandle::getSourceLine(size_t lineNum)
             currentLine++;
             if (currentLine > lineNum) break;
         }
-        pos++;
+        pos += bytes;
     }
     
     return line;
@@ -95,21 +106,21 @@ void ErrorHandle::printErrorLevel(ErrorLevel level)
     switch (level) {
     case LEVEL_NOTE:
         setColor(COLOR_CYAN);
-        wcout << L"note: ";
+        *out << L"note: ";
         break;
     case LEVEL_WARNING:
         setColor(COLOR_YELLOW);
-        wcout << L"warning: ";
+        *out << L"warning: ";
         warnCnt++;
         break;
     case LEVEL_ERROR:
         setColor(COLOR_RED);
-        wcout << L"error: ";
+        *out << L"error: ";
         errCnt++;
         break;
     case LEVEL_FATAL:
         setColor(COLOR_RED);
-        wcout << L"fatal error: ";
+        *out << L"fatal error: ";
         errCnt++;
         break;
     }
@@ -125,9 +136,9 @@ void ErrorHandle::printLocation(size_t row, size_t col)
 {
     setColor(COLOR_WHITE);
     if (!currentFileName.empty()) {
-        wcout << currentFileName << L":";
+        *out << currentFileName << L":";
     }
-    wcout << row << L":" << col << L": ";
+    *out << row << L":" << col << L": ";
     resetColor();
 }
 
@@ -144,26 +155,26 @@ void ErrorHandle::printSourceSnippet(size_t row, size_t col, size_t highlightLen
     
     // 打印行号
     setColor(COLOR_CYAN);
-    wcout << L"   " << row << L" | ";
+    *out << L"   " << row << L" | ";
     resetColor();
     
     // 打印源代码行，高亮错误位置
     for (size_t i = 0; i < sourceLine.length(); ++i) {
         if (i + 1 >= col && i + 1 < col + highlightLen) {
             setColor(COLOR_RED);
-            wcout << sourceLine[i];
+            *out << sourceLine[i];
             resetColor();
         } else {
-            wcout << sourceLine[i];
+            *out << sourceLine[i];
         }
     }
-    wcout << endl;
+    *out << endl;
     
     // 打印位置指示器
     setColor(COLOR_CYAN);
-    wcout << L"     | ";
+    *out << L"     | ";
     setColor(COLOR_GREEN);
-    wcout << generatePointer(col, highlightLen) << endl;
+    *out << generatePointer(col, highlightLen) << endl;
     resetColor();
 }
 
@@ -182,7 +193,7 @@ void ErrorHandle::printFormattedError(ErrorLevel level, const wchar_t* msg,
     
     // 打印错误消息
     setColor(COLOR_WHITE);
-    wcout << msg << endl;
+    *out << msg << endl;
     resetColor();
     
     // 打印源码片段
@@ -191,13 +202,13 @@ void ErrorHandle::printFormattedError(ErrorLevel level, const wchar_t* msg,
     // 打印修复建议
     if (suggestion != nullptr && wcslen(suggestion) > 0) {
         setColor(COLOR_CYAN);
-        wcout << L"     | ";
+        *out << L"     | ";
         setColor(COLOR_GREEN);
-        wcout << L"hint: " << suggestion << endl;
+        *out << L"hint: " << suggestion << endl;
         resetColor();
     }
     
-    wcout << endl;
+    *out << endl;
 }
 
 /* ============================================================
@@ -297,51 +308,44 @@ void ErrorHandle::error(const unsigned int n, const wchar_t* extra,
     }
     
     // 生成修复建议
+    wchar_t suggestionBuf[256];
     const wchar_t* suggestion = nullptr;
     if (n == MISSING) {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Add '%s' here", extra);
         suggestion = suggestionBuf;
     }
     else if(n == UNDECLARED_IDENT||n == UNDECLARED_PROC)
     {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Declare '%s' first", extra);
         suggestion = suggestionBuf;
     }
     else if(n == ILLEGAL_DEFINE||n == ILLEGAL_WORD)
     {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Please check the '%s'", extra);
         suggestion = suggestionBuf;
     }
     else if(n == EXPECT)
     {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Expected '%s' here", extra);
         suggestion = suggestionBuf;
     }
     else if(n == REDUNDENT)
     {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Remove '%s' here", extra);
         suggestion = suggestionBuf;
     }
     else if(n == UNDEFINED_PROC)
     {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Define '%s' first", extra);
         suggestion = suggestionBuf;
     }
     else if(n == REDECLEARED_IDENT)
     {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Did not redeclare the identifier '%s'", extra);
         suggestion = suggestionBuf;
     }
     else if(n == REDECLEARED_PROC)
     {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Did not redeclare the procedure name '%s'", extra);
         suggestion = suggestionBuf;
     }
@@ -361,15 +365,14 @@ void ErrorHandle::error(const unsigned int n, const wchar_t* extra1, const wchar
     size_t row = rowPos, col = colPos;
 
     // 生成修复建议
+    wchar_t suggestionBuf[256];
     const wchar_t* suggestion = nullptr;
     if (n == EXPECT_STH_FIND_ANTH) {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Did you mean '%s' instead of '%s'?", extra1, extra2);
         suggestion = suggestionBuf;
     }
     else if(n == SYNTAX_ERROR)
     {
-        static wchar_t suggestionBuf[256];
         swprintf_s(suggestionBuf, 256, L"Please check the syntax: '%s'", extra1);
         suggestion = suggestionBuf;
     }
@@ -409,32 +412,32 @@ void ErrorHandle::warning(const wstring& msg, size_t row, size_t col)
  */
 void ErrorHandle::printSummary()
 {
-    wcout << L"─────────────────────────────────────────────────────────" << endl;
+    *out << L"─────────────────────────────────────────────────────────" << endl;
     
     if (errCnt == 0 && warnCnt == 0) {
         setColor(COLOR_GREEN);
-        wcout << L"✓ ";
+        *out << L"✓ ";
         resetColor();
-        wcout << L"Build succeeded with no errors or warnings." << endl;
+        *out << L"Build succeeded with no errors or warnings." << endl;
     } else {
         // 统计信息
         if (errCnt > 0) {
             setColor(COLOR_RED);
-            wcout << L"✗ ";
+            *out << L"✗ ";
             resetColor();
-            wcout << errCnt << L" error(s)";
+            *out << errCnt << L" error(s)";
         }
         if (warnCnt > 0) {
-            if (errCnt > 0) wcout << L", ";
+            if (errCnt > 0) *out << L", ";
             setColor(COLOR_YELLOW);
-            wcout << L"⚠ ";
+            *out << L"⚠ ";
             resetColor();
-            wcout << warnCnt << L" warning(s)";
+            *out << warnCnt << L" warning(s)";
         }
-        wcout << L" generated." << endl;
+        *out << L" generated." << endl;
     }
     
-    wcout << L"─────────────────────────────────────────────────────────" << endl;
+    *out << L"─────────────────────────────────────────────────────────" << endl;
 }
 
 /**
@@ -442,17 +445,17 @@ void ErrorHandle::printSummary()
  */
 void ErrorHandle::over()
 {
-    wcout << endl;
+    *out << endl;
     printSummary();
     
     if (errCnt == 0) {
         setColor(COLOR_GREEN);
-        wcout << L"Compilation successful!" << endl;
+        *out << L"Compilation successful!" << endl;
         resetColor();
     } else {
         setColor(COLOR_RED);
-        wcout << L"Compilation failed." << endl;
+        *out << L"Compilation failed." << endl;
         resetColor();
     }
-    wcout << endl;
+    *out << endl;
 }
@@ -6,9 +6,6 @@
 
 #include <Interpreter.hpp>
 
-// 解释器全局实例
-Interpreter interpreter;
-
 /**
  * @brief 初始化解释器
  * @details 重置程序计数器、栈顶指针和基址寄存器
@@ -204,21 +201,17 @@ void Interpreter::cal(Operation op, int L, int a)
  * @param op 操作码
  * @param L 层差(未使用)
  * @param a 分配单元数
- * @details 在栈顶分配a个存储单元
+ * @param b 过程内栈顶的最大高度(AnalyzeFrames填写，0表示未分析)
+ * @details 在栈顶分配a个存储单元；已分析时一次扩展到整个活动记录连同临时值所需的空间
  */
-void Interpreter::alc(Operation op, int L, int a)
+void Interpreter::alc(Operation op, int L, int a, int b)
 {
-    size_t cur_size = running_stack.size();
-    
-    if (a <= cur_size - top) {
-        top += a;
-    }
-    else {
+    size_t need = max(top + a, sp + b);
+    if (need > running_stack.size()) {
         // 需要扩展栈空间
-        for (int i = 0; i < a - (cur_size - top); i++)
-            running_stack.push_back(0);
-        top = running_stack.size();
+        running_stack.resize(need);
     }
+    top += a;
     
     // 设置全局display指针
     running_stack[sp + GLO_DISPLAY] = sp + DISPLAY;
@@ -257,13 +250,13 @@ void Interpreter::jpc(Operation op, int L, int a)
  * @param op 操作码
  * @param L 层差(未使用)
  * @param a 地址(未使用)
- * @details 从控制台读取一个整数并压入栈顶
+ * @details 从输入流(默认控制台)读取一个整数并压入栈顶
  */
 void Interpreter::red(Operation op, int L, int a)
 {
-    int data;
-    wcout << "read: ";
-    wcin >> data;
+    int data = 0;
+    *out << "read: ";
+    *in >> data;
     
     if (top == running_stack.size())
         running_stack.push_back(data);
@@ -282,22 +275,139 @@ void Interpreter::red(Operation op, int L, int a)
  */
 void Interpreter::wrt(Operation op, int L, int a)
 {
-    wcout << "write: " << running_stack[top - 1] << endl;
+    *out << "write: " << running_stack[top - 1] << endl;
     top--;
     pc++;
 }
 
+/**
+ * @brief 关系运算
+ * @param rel 运算类型(OPR_EQL ~ OPR_LEQ)
+ */
+static bool Relation(int rel, int lhs, int rhs)
+{
+    switch (rel)
+    {
+    case OPR_EQL: return lhs == rhs;
+    case OPR_NEQ: return lhs != rhs;
+    case OPR_LSS: return lhs < rhs;
+    case OPR_GEQ: return lhs >= rhs;
+    case OPR_GRT: return lhs > rhs;
+    case OPR_LEQ: return lhs <= rhs;
+    default:      return false;
+    }
+}
+
+/**
+ * @brief 执行STI指令 - 存储常量
+ * @param L 层差，-1表示传递实参
+ * @param a 相对偏移
+ * @param b 常量
+ * @details 等价于LIT b; STO L,a，传递实参时同样预先开辟空间
+ */
+void Interpreter::sti(Operation op, int L, int a, int b)
+{
+    if (L >= 0) {
+        running_stack[running_stack[sp + DISPLAY + L] + a] = b;
+    }
+    else {
+        size_t cur_size = running_stack.size();
+        for (int i = cur_size - top; i <= a; i++)
+            running_stack.push_back(0);
+        running_stack[top + a] = b;
+    }
+    pc++;
+}
+
+/**
+ * @brief 执行ADI指令 - 栈顶加常量
+ * @param a 加数(减法已折算为加负数)
+ */
+void Interpreter::adi(Operation op, int L, int a)
+{
+    running_stack[top - 1] = (int)((unsigned)running_stack[top - 1] + (unsigned)a);
+    pc++;
+}
+
+/**
+ * @brief 执行LAI指令 - 取变量加常量
+ * @param L 层差
+ * @param a 相对偏移
+ * @param b 加数
+ */
+void Interpreter::lai(Operation op, int L, int a, int b)
+{
+    int value = (int)((unsigned)running_stack[running_stack[sp + DISPLAY + L] + a] + (unsigned)b);
+    if (top == running_stack.size())
+        running_stack.push_back(value);
+    else
+        running_stack[top] = value;
+    top++;
+    pc++;
+}
+
+/**
+ * @brief 执行INC指令 - 变量原地加常量
+ * @param L 层差
+ * @param a 相对偏移
+ * @param b 加数
+ */
+void Interpreter::inc(Operation op, int L, int a, int b)
+{
+    int& var = running_stack[running_stack[sp + DISPLAY + L] + a];
+    var = (int)((unsigned)var + (unsigned)b);
+    pc++;
+}
+
+/**
+ * @brief 执行CJP指令 - 比较并条件跳转
+ * @param L 关系运算类型
+ * @param a 目标地址
+ * @details 弹出两个值，比较不成立时跳转
+ */
+void Interpreter::cjp(Operation op, int L, int a)
+{
+    bool res = Relation(L, running_stack[top - 2], running_stack[top - 1]);
+    top -= 2;
+    pc = res ? pc + 1 : a;
+}
+
+/**
+ * @brief 执行CJI指令 - 与常量比较并条件跳转
+ * @param L 关系运算类型
+ * @param a 目标地址
+ * @param b 常量(右操作数)
+ */
+void Interpreter::cji(Operation op, int L, int a, int b)
+{
+    bool res = Relation(L, running_stack[top - 1], b);
+    top--;
+    pc = res ? pc + 1 : a;
+}
+
 /**
  * @brief 启动解释执行
- * @details 初始化后逐条执行P-Code指令
+ * @details 初始化后逐条执行P-Code指令，同时统计分派的指令条数；
+ *          启用直接线索化执行或固定容量栈时改由RunThreaded执行
  */
 void Interpreter::run()
 {
     Init();
+    dispatched = 0;
+    stackOverflow = false;
+    if (fixedStack.Data() != nullptr && !pcodelist.code_list.empty()) {
+        RunThreaded<true>();
+        return;
+    }
+    if (threaded && !pcodelist.code_list.empty()) {
+        RunThreaded<false>();
+        return;
+    }
     
     // 按pc指示逐条执行指令
     for (int i = 0; i < pcodelist.code_list.size() - 1; i = pc) {
         PCode code = pcodelist.code_list[i];
+        dispatched++;
         
         switch (code.op) {
         case Operation::lit:
@@ -316,7 +426,7 @@ void Interpreter::run()
             cal(code.op, code.L, code.a);
             break;
         case Operation::alloc:
-            alc(code.op, code.L, code.a);
+            alc(code.op, code.L, code.a, code.b);
             break;
         case Operation::jmp:
             jmp(code.op, code.L, code.a);
@@ -330,12 +440,287 @@ void Interpreter::run()
         case Operation::wrt:
             wrt(code.op, code.L, code.a);
             break;
+        case Operation::sti:
+            sti(code.op, code.L, code.a, code.b);
+            break;
+        case Operation::adi:
+            adi(code.op, code.L, code.a);
+            break;
+        case Operation::lai:
+            lai(code.op, code.L, code.a, code.b);
+            break;
+        case Operation::inc:
+            inc(code.op, code.L, code.a, code.b);
+            break;
+        case Operation::cjp:
+            cjp(code.op, code.L, code.a);
+            break;
+        case Operation::cji:
+            cji(code.op, code.L, code.a, code.b);
+            break;
         default:
             break;
         }
     }
 }
 
+/* ============================================================
+ *                      直接线索化执行
+ * ============================================================ */
+
+/*
+ * 处理程序列表: HALT之后依次为基本指令、按运算类型拆分的OPR、超级指令；
+ * OPR与CJP/CJI中关系运算的顺序与OPR_*的编号一致，译码时直接按编号偏移
+ */
+#define THREADED_HANDLERS(X) \
+    X(HALT) X(LIT) X(LOD) X(STO) X(ARG) X(CAL) X(INT) X(JMP) X(JPC) X(RED) X(WRT) \
+    X(RET) X(NEG) X(ADD) X(SUB) X(MUL) X(DIV) X(ODD) X(EQ) X(NE) X(LT) X(GE) X(GT) X(LE) X(NOP) \
+    X(STI) X(STI_ARG) X(ADI) X(LAI) X(INC) \
+    X(CJP_EQ) X(CJP_NE) X(CJP_LT) X(CJP_GE) X(CJP_GT) X(CJP_LE) \
+    X(CJI_EQ) X(CJI_NE) X(CJI_LT) X(CJI_GE) X(CJI_GT) X(CJI_LE)
+
+#define THREADED_KIND(name) T_##name,
+enum ThreadedKind { THREADED_HANDLERS(THREADED_KIND) T_CNT };
+#undef THREADED_KIND
+
+// GCC/Clang支持标签地址(labels as values)时用computed goto分派，否则退回switch
+#if defined(__GNUC__) || defined(__clang__)
+#define THREADED_GOTO 1
+#endif
+
+/**
+ * @brief 确定指令的处理程序编号
+ */
+static int ThreadedKindOf(const PCode& code)
+{
+    switch (code.op)
+    {
+    case lit:   return T_LIT;
+    case opr:   return code.a >= OPR_RETURN && code.a <= OPR_LEQ ? T_RET + code.a : T_NOP;
+    case load:  return T_LOD;
+    case store: return code.L >= 0 ? T_STO : T_ARG;
+    case call:  return T_CAL;
+    case alloc: return T_INT;
+    case jmp:   return T_JMP;
+    case jpc:   return T_JPC;
+    case red:   return T_RED;
+    case wrt:   return T_WRT;
+    case sti:   return code.L >= 0 ? T_STI : T_STI_ARG;
+    case adi:   return T_ADI;
+    case lai:   return T_LAI;
+    case inc:   return T_INC;
+    case cjp:   return T_CJP_EQ + code.L - OPR_EQL;
+    case cji:   return T_CJI_EQ + code.L - OPR_EQL;
+    default:    return T_NOP;
+    }
+}
+
+/**
+ * @brief 设置固定容量运行时栈
+ * @param cells 存储单元数，0表示恢复按需扩展
+ * @param flags 选项(STACK_*)
+ * @return 申请成功返回true
+ * @details 使用固定容量栈时总是直接线索化执行
+ */
+bool Interpreter::SetFixedStack(size_t cells, unsigned flags)
+{
+    if (cells == 0) {
+        fixedStack.Release();
+        return true;
+    }
+    return fixedStack.Allocate(cells, flags);
+}
+
+/**
+ * @brief 直接线索化执行
+ * @tparam Fixed 是否使用固定容量栈
+ * @details 先把指令序列预译码为处理程序地址加操作数，最后一条指令及其后一位译为停机；
+ *          执行时栈顶、基址与指令指针都放在局部变量中，每个处理程序末尾直接跳到下一条的处理程序，
+ *          不再经过统一的分派点。各处理程序与逐条解释的语义逐条相同，包括运行时栈的增长方式。
+ *
+ *          固定容量栈上压栈只是一次存储，溢出在分配活动记录(INT)与传递实参时按帧检查：
+ *          语句执行前后栈平衡，一条语句求值中的临时值不超过全部压栈指令的条数，
+ *          因此INT在活动记录之上再预留这么多单元(外加调用时写入的活动记录头部)即可保证帧内压栈不越界；
+ *          空间不足时报告运行时错误并停机
+ */
+template <bool Fixed>
+void Interpreter::RunThreaded()
+{
+#ifdef THREADED_GOTO
+#define THREADED_LABEL(name) &&L_##name,
+    static const void* const labels[T_CNT] = { THREADED_HANDLERS(THREADED_LABEL) };
+#undef THREADED_LABEL
+#define HANDLER(name) L_##name:
+#define NEXT() do { count++; goto *ip->handler; } while (0)
+#else
+#define HANDLER(name) case T_##name:
+#define NEXT() do { count++; goto dispatch; } while (0)
+#endif
+
+    // 预译码，同时统计帧内临时值的上界
+    const vector<PCode>& code = pcodelist.code_list;
+    const size_t n = code.size();
+    size_t pushes = 0;
+    int level = 0;
+    decoded.resize(n + 1);
+    for (size_t i = 0; i <= n; i++) {
+        ThreadedCode& inst = decoded[i];
+        if (i + 1 >= n) {
+            inst = ThreadedCode{ nullptr, T_HALT, 0, 0, 0 };
+        }
+        else {
+            inst = ThreadedCode{ nullptr, ThreadedKindOf(code[i]), code[i].L, code[i].a, code[i].b };
+            if (inst.kind == T_JMP || inst.kind == T_JPC || inst.kind == T_CAL
+                || (inst.kind >= T_CJP_EQ && inst.kind <= T_CJI_LE)) {
+                inst.a = min(inst.a, (int)n);
+            }
+            if (inst.kind == T_LIT || inst.kind == T_LOD || inst.kind == T_RED || inst.kind == T_LAI) {
+                pushes++;
+            }
+            if (inst.kind == T_CAL) {
+                level = max(level, inst.L);
+            }
+        }
+#ifdef THREADED_GOTO
+        inst.handler = labels[inst.kind];
+#endif
+    }
+
+    const ThreadedCode* const base = decoded.data();
+    const ThreadedCode* ip = base;
+    int* st = Fixed ? fixedStack.Data() : running_stack.data();
+    size_t size = Fixed ? fixedStack.Capacity() : running_stack.size();
+    const size_t frameReserve = pushes + DISPLAY + 2 + level;   // 未经栈深度分析时INT在活动记录之上预留的单元数
+    size_t top = 0, sp = 0;
+    size_t count = 0;
+
+    // 压栈，按需扩展时栈满则扩展运行时栈并重新取得栈底地址
+#define PUSH(value) do { int pushed = (value); \
+        if (!Fixed && top == size) { running_stack.push_back(pushed); st = running_stack.data(); size++; } \
+        else st[top] = pushed; \
+        top++; } while (0)
+    // 在top之上开辟到top+a为止的空间(传递实参)，固定容量栈只检查是否越界
+#define RESERVE(a) do { if (Fixed) { if (top + (a) >= size) goto overflow; } \
+        else { for (int i = size - top; i <= (a); i++) running_stack.push_back(0); \
+               st = running_stack.data(); size = running_stack.size(); } } while (0)
+    // 关系运算、比较并跳转、与常量比较并跳转
+#define RELATION(name, op) \
+    HANDLER(name) { st[top - 2] = st[top - 2] op st[top - 1]; top--; ip++; NEXT(); } \
+    HANDLER(CJP_##name) { bool res = st[top - 2] op st[top - 1]; top -= 2; ip = res ? ip + 1 : base + ip->a; NEXT(); } \
+    HANDLER(CJI_##name) { bool res = st[top - 1] op ip->b; top--; ip = res ? ip + 1 : base + ip->a; NEXT(); }
+
+    NEXT();
+#ifndef THREADED_GOTO
+dispatch:
+    switch (ip->kind)
+    {
+#endif
+    HANDLER(LIT) { PUSH(ip->a); ip++; NEXT(); }
+    HANDLER(LOD) { PUSH(st[st[sp + DISPLAY + ip->L] + ip->a]); ip++; NEXT(); }
+    HANDLER(STO) { st[st[sp + DISPLAY + ip->L] + ip->a] = st[top - 1]; top--; ip++; NEXT(); }
+    HANDLER(ARG) {
+        int val = st[top - 1];
+        top--;
+        RESERVE(ip->a);
+        st[top + ip->a] = val;
+        ip++;
+        NEXT();
+    }
+    HANDLER(CAL) {
+        int L = ip->L;
+        st[top + RETURN_ADDRESS] = (int)(ip - base) + 1;
+        for (int i = 0; i <= L; i++)
+            st[top + DISPLAY + i] = st[st[sp + GLO_DISPLAY] + i];
+        st[top + DISPLAY + L + 1] = top;
+        st[top + OLD_SP] = sp;
+        sp = top;
+        ip = base + ip->a;
+        NEXT();
+    }
+    HANDLER(INT) {
+        // 已分析时一次确保整个活动记录连同临时值的空间，否则固定容量栈按上界检查
+        size_t a = ip->a;
+        size_t need = ip->b > 0 ? max(top + a, sp + ip->b) : top + a;
+        if (Fixed && (ip->b > 0 ? need : need + frameReserve) > size) {
+            goto overflow;
+        }
+        if (!Fixed && need > size) {
+            running_stack.resize(need);
+            st = running_stack.data();
+            size = need;
+        }
+        top += a;
+        st[sp + GLO_DISPLAY] = sp + DISPLAY;
+        ip++;
+        NEXT();
+    }
+    HANDLER(JMP) { ip = base + ip->a; NEXT(); }
+    HANDLER(JPC) { ip = st[top - 1] == false ? base + ip->a : ip + 1; top--; NEXT(); }
+    HANDLER(RED) {
+        int data = 0;
+        *out << "read: ";
+        *in >> data;
+        PUSH(data);
+        ip++;
+        NEXT();
+    }
+    HANDLER(WRT) { *out << "write: " << st[top - 1] << endl; top--; ip++; NEXT(); }
+    HANDLER(RET) {
+        ip = base + st[sp + RETURN_ADDRESS];
+        int old_sp = st[sp + OLD_SP];
+        top = sp;
+        sp = old_sp;
+        NEXT();
+    }
+    HANDLER(NEG) { st[top - 1] = ~st[top - 1] + 1; ip++; NEXT(); }
+    HANDLER(ADD) { st[top - 2] = st[top - 2] + st[top - 1]; top--; ip++; NEXT(); }
+    HANDLER(SUB) { st[top - 2] = st[top - 2] - st[top - 1]; top--; ip++; NEXT(); }
+    HANDLER(MUL) { st[top - 2] = st[top - 2] * st[top - 1]; top--; ip++; NEXT(); }
+    HANDLER(DIV) { st[top - 2] = st[top - 2] / st[top - 1]; top--; ip++; NEXT(); }
+    HANDLER(ODD) { st[top - 1] = (st[top - 1] & 0b1) == 1; ip++; NEXT(); }
+    RELATION(EQ, ==)
+    RELATION(NE, !=)
+    RELATION(LT, <)
+    RELATION(GE, >=)
+    RELATION(GT, >)
+    RELATION(LE, <=)
+    HANDLER(NOP) { ip++; NEXT(); }
+    HANDLER(STI) { st[st[sp + DISPLAY + ip->L] + ip->a] = ip->b; ip++; NEXT(); }
+    HANDLER(STI_ARG) { RESERVE(ip->a); st[top + ip->a] = ip->b; ip++; NEXT(); }
+    HANDLER(ADI) { st[top - 1] = (int)((unsigned)st[top - 1] + (unsigned)ip->a); ip++; NEXT(); }
+    HANDLER(LAI) { PUSH((int)((unsigned)st[st[sp + DISPLAY + ip->L] + ip->a] + (unsigned)ip->b)); ip++; NEXT(); }
+    HANDLER(INC) {
+        int& var = st[st[sp + DISPLAY + ip->L] + ip->a];
+        var = (int)((unsigned)var + (unsigned)ip->b);
+        ip++;
+        NEXT();
+    }
+    HANDLER(HALT) { count--; goto halt; }     // 停机本身不计入分派次数
+#ifndef THREADED_GOTO
+    default:
+        count--;
+        goto halt;
+    }
+#endif
+
+overflow:
+    stackOverflow = true;
+    *out << L"[Runtime Error] 运行时栈溢出: 固定栈容量 " << size << L" 个存储单元不足 (pc = "
+         << ip - base << L")" << endl;
+halt:
+#undef RELATION
+#undef RESERVE
+#undef PUSH
+#undef NEXT
+#undef HANDLER
+
+    pc = ip - base;
+    this->top = top;
+    this->sp = sp;
+    dispatched = count;
+}
+
+
 /**
  * @brief 清空解释器状态
  */
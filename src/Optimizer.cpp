@@ -0,0 +1,605 @@
+/**
+ * @file Optimizer.cpp
+ * @brief P-Code优化实现
+ * @details 解释器在执行到最后一条指令(主程序的返回)时停机，
+ *          因此最后一条指令始终保留在末尾，也不会被复制到其他位置
+ */
+
+#include <Optimizer.hpp>
+
+/**
+ * @brief 编译期计算运算结果
+ * @param op 运算类型(OPR_*)
+ * @param lhs 左操作数(一元运算的唯一操作数)
+ * @param rhs 右操作数(一元运算忽略)
+ * @param result 输出运算结果
+ * @return 可以在编译期计算返回true；除以0、INT_MIN/-1等运行时会出错的运算
+ *         以及非运算的OPR返回false，保留到运行时
+ * @details 加减乘与取负按补码回绕，与解释器在常见平台上的结果一致
+ */
+bool FoldOperation(int op, int lhs, int rhs, int& result)
+{
+    unsigned a = (unsigned)lhs, b = (unsigned)rhs;
+    switch (op)
+    {
+    case OPR_NEGTIVE:   result = (int)(0u - a); return true;
+    case OPR_ODD:       result = (lhs & 0b1) == 1; return true;
+    case OPR_ADD:       result = (int)(a + b); return true;
+    case OPR_SUB:       result = (int)(a - b); return true;
+    case OPR_MULTI:     result = (int)(a * b); return true;
+    case OPR_DIVIS:
+        if (rhs == 0 || (lhs == INT_MIN && rhs == -1)) {
+            return false;
+        }
+        result = lhs / rhs;
+        return true;
+    case OPR_EQL:       result = lhs == rhs; return true;
+    case OPR_NEQ:       result = lhs != rhs; return true;
+    case OPR_LSS:       result = lhs < rhs; return true;
+    case OPR_LEQ:       result = lhs <= rhs; return true;
+    case OPR_GRT:       result = lhs > rhs; return true;
+    case OPR_GEQ:       result = lhs >= rhs; return true;
+    default:            return false;
+    }
+}
+
+/**
+ * @brief 指令是否以a字段为跳转目标
+ */
+static bool HasTarget(const PCode& code)
+{
+    return code.op == jmp || code.op == jpc || code.op == call || code.op == cjp || code.op == cji;
+}
+
+/**
+ * @brief 是否为过程返回指令
+ */
+static bool IsReturn(const PCode& code)
+{
+    return code.op == opr && code.a == OPR_RETURN;
+}
+
+/**
+ * @brief 跳转链直达
+ * @details 目标为JMP的跳转、条件跳转与调用改为直接跳到链尾；
+ *          链尾为过程返回(程序末尾除外)的JMP直接改为返回
+ * @return 是否有改动
+ */
+static bool RetargetJumps(vector<PCode>& code, PeepholeStats& stats)
+{
+    bool changed = false;
+    const size_t last = code.size() - 1;
+    for (PCode& inst : code) {
+        if (!HasTarget(inst)) {
+            continue;
+        }
+        size_t target = inst.a;
+        for (size_t steps = 0; target < code.size() && code[target].op == jmp && steps < code.size(); steps++) {
+            target = code[target].a;
+        }
+        if (target != (size_t)inst.a) {
+            inst.a = (int)target;
+            stats.retargeted++;
+            changed = true;
+        }
+        if (inst.op == jmp && target < last && IsReturn(code[target])) {
+            inst = code[target];
+            stats.rewritten++;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief 匹配并改写短指令窗口
+ * @param keep 输出待删除的指令(置为false)
+ * @details 两条指令的窗口要求第二条不是任何跳转的目标，
+ *          被删除的窗口整体等价于空操作，跳到其首条的控制流落到其后继即可
+ * @return 是否有改动
+ */
+static bool RewriteWindows(vector<PCode>& code, vector<bool>& keep, unsigned rules, PeepholeStats& stats)
+{
+    const size_t last = code.size() - 1;
+    vector<bool> isTarget(code.size() + 1, false);
+    for (const PCode& inst : code) {
+        if (HasTarget(inst) && (size_t)inst.a < isTarget.size()) {
+            isTarget[inst.a] = true;
+        }
+    }
+
+    bool changed = false;
+    for (size_t i = 0; i < last; i++) {
+        PCode& first = code[i];
+        if ((rules & PEEP_JUMP_NEXT) && first.op == jmp && (size_t)first.a == i + 1) {
+            keep[i] = false;
+            changed = true;
+            continue;
+        }
+        if (i + 1 >= last || isTarget[i + 1]) {
+            continue;
+        }
+
+        const PCode& second = code[i + 1];
+        bool remove = false;
+        if ((rules & PEEP_NEGATE) && second.op == opr && second.a == OPR_NEGTIVE) {
+            if (first.op == lit) {
+                FoldOperation(OPR_NEGTIVE, first.a, 0, first.a);
+                keep[i + 1] = false;
+                stats.rewritten++;
+                changed = true;
+                i++;
+                continue;
+            }
+            remove = first.op == opr && first.a == OPR_NEGTIVE;
+        }
+        if ((rules & PEEP_IDENTITY) && first.op == lit && second.op == opr) {
+            remove = remove || (first.a == 0 && (second.a == OPR_ADD || second.a == OPR_SUB))
+                            || (first.a == 1 && (second.a == OPR_MULTI || second.a == OPR_DIVIS));
+        }
+        if ((rules & PEEP_LOAD_STORE) && first.op == load && second.op == store) {
+            remove = remove || (first.L == second.L && first.a == second.a && first.L >= 0);
+        }
+        if (remove) {
+            keep[i] = false;
+            keep[i + 1] = false;
+            changed = true;
+            i++;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief 标记不可达指令
+ * @details 从0号指令出发沿顺序执行、跳转与调用目标遍历；
+ *          调用返回后从调用的下一条继续，返回与无条件跳转没有顺序后继
+ * @return 是否有改动
+ */
+static bool MarkUnreachable(const vector<PCode>& code, vector<bool>& keep)
+{
+    vector<bool> reached(code.size(), false);
+    vector<size_t> work(1, 0);
+    while (!work.empty())
+    {
+        size_t i = work.back();
+        work.pop_back();
+        if (i >= code.size() || reached[i]) {
+            continue;
+        }
+        reached[i] = true;
+        const PCode& inst = code[i];
+        if (HasTarget(inst)) {
+            work.push_back(inst.a);
+        }
+        if (inst.op != jmp && !IsReturn(inst)) {
+            work.push_back(i + 1);
+        }
+    }
+
+    bool changed = false;
+    for (size_t i = 0; i + 1 < code.size(); i++) {
+        if (!reached[i] && keep[i]) {
+            keep[i] = false;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief 删除指令并重定位跳转目标
+ * @details 目标指向被删除的指令时改为其后第一条保留的指令
+ */
+static void Compact(vector<PCode>& code, const vector<bool>& keep, PeepholeStats& stats)
+{
+    vector<int> newIndex(code.size() + 1);
+    int kept = 0;
+    for (size_t i = 0; i < code.size(); i++) {
+        newIndex[i] = kept;
+        kept += keep[i];
+    }
+    newIndex[code.size()] = kept;
+
+    size_t out = 0;
+    for (size_t i = 0; i < code.size(); i++) {
+        if (!keep[i]) {
+            continue;
+        }
+        PCode inst = code[i];
+        if (HasTarget(inst)) {
+            inst.a = newIndex[min((size_t)inst.a, code.size())];
+        }
+        code[out++] = inst;
+    }
+    stats.removed += code.size() - out;
+    code.erase(code.begin() + out, code.end());
+}
+
+/**
+ * @brief 窥孔优化
+ * @param pcodelist 指令序列，原地改写
+ * @param rules 启用的规则(PEEP_*)
+ * @return 优化统计
+ * @details 各规则交替执行直到不再变化；符号表中记录的过程入口仍指向优化前的地址
+ */
+PeepholeStats PeepholeOptimize(PCodeList& pcodelist, unsigned rules)
+{
+    vector<PCode>& code = pcodelist.code_list;
+    PeepholeStats stats;
+    stats.before = code.size();
+    bool changed = !code.empty();
+    while (changed)
+    {
+        stats.passes++;
+        changed = false;
+        if (rules & PEEP_JUMP_CHAIN) {
+            changed = RetargetJumps(code, stats) || changed;
+        }
+        vector<bool> keep(code.size(), true);
+        changed = RewriteWindows(code, keep, rules, stats) || changed;
+        if (rules & PEEP_UNREACHABLE) {
+            changed = MarkUnreachable(code, keep) || changed;
+        }
+        Compact(code, keep, stats);
+    }
+    stats.after = code.size();
+    return stats;
+}
+
+/**
+ * @brief 是否为加法或减法
+ */
+static bool IsAddSub(const PCode& code)
+{
+    return code.op == opr && (code.a == OPR_ADD || code.a == OPR_SUB);
+}
+
+/**
+ * @brief 是否为关系运算
+ */
+static bool IsRelation(const PCode& code)
+{
+    return code.op == opr && code.a >= OPR_EQL && code.a <= OPR_LEQ;
+}
+
+/**
+ * @brief 加减常量折算为加数
+ * @param value LIT的常量
+ * @param operation 其后的OPR ADD/SUB
+ */
+static int Addend(int value, const PCode& operation)
+{
+    return operation.a == OPR_ADD ? value : (int)(0u - (unsigned)value);
+}
+
+/**
+ * @brief 匹配以i开始的指令序列并合并为一条超级指令
+ * @param length 输出被合并的指令条数
+ * @return 是否匹配
+ * @details 较长的模式优先；序列不含最后一条指令
+ */
+static bool MatchSuper(const vector<PCode>& code, size_t i, size_t& length, PCode& fused)
+{
+    const size_t last = code.size() - 1;
+    auto at = [&](size_t k) -> const PCode* { return i + k < last ? &code[i + k] : nullptr; };
+    const PCode* first = at(0);
+    const PCode* second = at(1);
+    const PCode* third = at(2);
+    const PCode* fourth = at(3);
+
+    if (first->op == load && second && second->op == lit && third && IsAddSub(*third)) {
+        int addend = Addend(second->a, *third);
+        if (fourth && fourth->op == store && fourth->L == first->L && fourth->a == first->a) {
+            fused = PCode(inc, first->L, first->a, addend);
+            length = 4;
+        }
+        else {
+            fused = PCode(lai, first->L, first->a, addend);
+            length = 3;
+        }
+        return true;
+    }
+    if (first->op == lit && second && IsRelation(*second) && third && third->op == jpc) {
+        fused = PCode(cji, second->a, third->a, first->a);
+        length = 3;
+        return true;
+    }
+    if (IsRelation(*first) && second && second->op == jpc) {
+        fused = PCode(cjp, first->a, second->a);
+        length = 2;
+        return true;
+    }
+    if (first->op == lit && second && second->op == store) {
+        fused = PCode(sti, second->L, second->a, first->a);
+        length = 2;
+        return true;
+    }
+    if (first->op == lit && second && IsAddSub(*second)) {
+        fused = PCode(adi, 0, Addend(first->a, *second));
+        length = 2;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 合并超级指令
+ * @param pcodelist 指令序列，原地改写
+ * @return 统计: rewritten为生成的超级指令数，removed为减少的指令数
+ * @details 在窥孔优化之后执行。被合并序列除首条外都不能是跳转目标；
+ *          OPR PRINT/PRINTLN在解释器中是空操作，一并删除。
+ *          超级指令省去的是中间结果的压栈与弹栈，运行结果与原序列相同
+ */
+PeepholeStats FuseSuperinstructions(PCodeList& pcodelist)
+{
+    vector<PCode>& code = pcodelist.code_list;
+    PeepholeStats stats;
+    stats.before = code.size();
+    if (code.empty()) {
+        return stats;
+    }
+    stats.passes = 1;
+
+    vector<bool> isTarget(code.size() + 1, false);
+    for (const PCode& inst : code) {
+        if (HasTarget(inst) && (size_t)inst.a < isTarget.size()) {
+            isTarget[inst.a] = true;
+        }
+    }
+
+    const size_t last = code.size() - 1;
+    vector<bool> keep(code.size(), true);
+    for (size_t i = 0; i < last; i++) {
+        if (code[i].op == opr && (code[i].a == OPR_PRINT || code[i].a == OPR_PRINTLN)) {
+            keep[i] = false;
+            continue;
+        }
+        size_t length;
+        PCode fused(lit, 0, 0);
+        if (!MatchSuper(code, i, length, fused)) {
+            continue;
+        }
+        bool inner = false;
+        for (size_t k = 1; k < length; k++) {
+            inner = inner || isTarget[i + k];
+        }
+        if (inner) {
+            continue;
+        }
+        code[i] = fused;
+        for (size_t k = 1; k < length; k++) {
+            keep[i + k] = false;
+        }
+        stats.rewritten++;
+        i += length - 1;
+    }
+    Compact(code, keep, stats);
+    stats.after = code.size();
+    return stats;
+}
+
+/**
+ * @brief 计算一条指令执行后的栈高度
+ * @param code 指令
+ * @param depth 执行前栈顶相对活动记录基址的高度
+ * @param after 输出执行后的高度
+ * @param high 输出执行期间写到的最高位置(不含)
+ * @return 高度合法(不低于0)返回true
+ * @details 传递实参的STO/STI写在弹栈后的top+a处；
+ *          CAL在栈顶之上写入被调过程的活动记录头部，含L+1项display
+ */
+static bool StepDepth(const PCode& code, int depth, int& after, int& high)
+{
+    after = depth;
+    high = depth;
+    switch (code.op)
+    {
+    case lit: case load: case red: case lai:
+        after = depth + 1;
+        break;
+    case store: case sti:
+        after = code.op == store ? depth - 1 : depth;
+        if (code.L < 0) {
+            high = after + code.a + 1;
+        }
+        break;
+    case opr:
+        if ((code.a >= OPR_ADD && code.a <= OPR_DIVIS) || IsRelation(code)) {
+            after = depth - 1;
+        }
+        break;
+    case jpc: case cji: case wrt:
+        after = depth - 1;
+        break;
+    case cjp:
+        after = depth - 2;
+        break;
+    case alloc:
+        after = depth + code.a;
+        break;
+    case call:
+        high = depth + ACT_PRE_REC_SIZE + code.L + 2;
+        break;
+    default:
+        break;
+    }
+    high = max(high, after);
+    return after >= 0;
+}
+
+/**
+ * @brief 分析一个过程的栈使用
+ * @param code 指令序列
+ * @param frame 输入entry，输出活动记录大小与最大高度
+ * @param calls 输出过程内的调用: (被调过程入口, 调用时的栈高度)
+ * @param depth 各指令执行前的高度，-1表示未到达；返回前恢复为-1
+ * @return 每条指令在各路径上的高度一致返回true
+ * @details 从入口沿顺序执行与跳转遍历，调用返回后从下一条继续，
+ *          到过程返回或停机位置为止
+ */
+static bool AnalyzeProcedure(const vector<PCode>& code, FrameInfo& frame, vector<pair<size_t, int>>& calls, vector<int>& depth)
+{
+    const size_t last = code.size() - 1;
+    vector<size_t> work(1, frame.entry), reached;
+    depth[frame.entry] = 0;
+    reached.push_back(frame.entry);
+    bool consistent = true;
+    while (!work.empty() && consistent)
+    {
+        size_t i = work.back();
+        work.pop_back();
+        const PCode& inst = code[i];
+        if (i >= last || IsReturn(inst)) {
+            continue;
+        }
+        int after, high;
+        consistent = StepDepth(inst, depth[i], after, high);
+        frame.maxDepth = max(frame.maxDepth, high);
+        if (inst.op == alloc && frame.frameSize == 0) {
+            frame.frameSize = inst.a;
+            frame.allocAt = i;
+        }
+        if (inst.op == call) {
+            calls.emplace_back(inst.a, depth[i]);
+        }
+        auto flow = [&](size_t next) {
+            if (next >= code.size()) {
+                return true;
+            }
+            if (depth[next] < 0) {
+                depth[next] = after;
+                reached.push_back(next);
+                work.push_back(next);
+            }
+            return depth[next] == after;
+        };
+        if (HasTarget(inst) && inst.op != call) {
+            consistent = flow(inst.a) && consistent;
+        }
+        if (inst.op != jmp) {
+            consistent = flow(i + 1) && consistent;
+        }
+    }
+    for (size_t i : reached) {
+        depth[i] = -1;
+    }
+    return consistent && frame.frameSize > 0;
+}
+
+/**
+ * @brief 计算过程连同其全部被调过程所需的栈单元数
+ * @param state 各过程的状态: 0未计算，1计算中，2已完成
+ * @return 所需单元数，递归或无法确定时为0
+ * @details 调用图上的回边说明存在递归，回边所在环上的过程都标记为递归
+ */
+static size_t FrameNeed(vector<FrameInfo>& frames, const vector<vector<pair<size_t, int>>>& calls,
+                        size_t index, vector<int>& state, vector<size_t>& path)
+{
+    FrameInfo& frame = frames[index];
+    if (state[index] == 2) {
+        return frame.need;
+    }
+    if (state[index] == 1) {
+        for (auto it = find(path.begin(), path.end(), index); it != path.end(); ++it) {
+            frames[*it].recursive = true;
+        }
+        return 0;
+    }
+    state[index] = 1;
+    path.push_back(index);
+    size_t need = frame.maxDepth;
+    for (const auto& edge : calls[index]) {
+        size_t callee = FrameNeed(frames, calls, edge.first, state, path);
+        need = callee == 0 || need == 0 ? 0 : max(need, edge.second + callee);
+    }
+    path.pop_back();
+    state[index] = 2;
+    frame.need = frame.recursive ? 0 : need;
+    return frame.need;
+}
+
+/**
+ * @brief 静态分析各过程的活动记录大小与最大栈深度
+ * @param pcodelist 指令序列，结果写入frames与stackBound，
+ *                  各过程INT指令的b字段记录其最大高度供解释器一次分配整个活动记录
+ * @details PL/0没有动态大小的栈使用，每条指令执行前栈顶相对活动记录基址的高度
+ *          与所经路径无关，沿控制流传播一遍即可得到。过程从0号指令与各CAL的目标出发；
+ *          调用图无环时整个程序所需的栈为主程序沿最深调用链的累计高度。
+ *          改写指令序列(窥孔优化、超级指令)后需重新分析
+ */
+void AnalyzeFrames(PCodeList& pcodelist)
+{
+    vector<PCode>& code = pcodelist.code_list;
+    vector<FrameInfo>& frames = pcodelist.frames;
+    frames.clear();
+    pcodelist.stackBound = 0;
+    if (code.empty()) {
+        return;
+    }
+
+    vector<vector<pair<size_t, int>>> calls;
+    vector<int> depth(code.size(), -1);
+    unordered_map<size_t, size_t> index{ { 0, 0 } };
+    frames.emplace_back();
+    bool complete = true;
+    for (size_t k = 0; k < frames.size(); k++) {
+        vector<pair<size_t, int>> edges;
+        if (!AnalyzeProcedure(code, frames[k], edges, depth)) {
+            frames[k].maxDepth = 0;
+            complete = false;
+        }
+        for (auto& edge : edges) {
+            auto found = index.find(edge.first);
+            if (found == index.end() && edge.first < code.size()) {
+                found = index.emplace(edge.first, frames.size()).first;
+                frames.emplace_back();
+                frames.back().entry = edge.first;
+            }
+            edge.first = found == index.end() ? k : found->second;
+            complete = complete && found != index.end();
+        }
+        calls.push_back(move(edges));
+    }
+
+    vector<int> state(frames.size(), 0);
+    vector<size_t> path;
+    for (size_t k = 0; k < frames.size(); k++) {
+        FrameNeed(frames, calls, k, state, path);
+        if (frames[k].maxDepth > 0) {
+            code[frames[k].allocAt].b = frames[k].maxDepth;
+        }
+    }
+    pcodelist.stackBound = complete ? frames[0].need : 0;
+}
+
+/**
+ * @brief 由规则名得到规则集
+ * @param names 逗号分隔的规则名: jumps, next, dead, negate, identity, loadstore, all
+ * @param rules 输出规则集
+ * @return 规则名均合法返回true
+ */
+bool ParsePeepholeRules(const string& names, unsigned& rules)
+{
+    static const pair<const char*, unsigned> table[] = {
+        { "jumps", PEEP_JUMP_CHAIN }, { "next", PEEP_JUMP_NEXT }, { "dead", PEEP_UNREACHABLE },
+        { "negate", PEEP_NEGATE }, { "identity", PEEP_IDENTITY }, { "loadstore", PEEP_LOAD_STORE },
+        { "all", PEEP_ALL },
+    };
+    rules = 0;
+    stringstream stream(names);
+    string name;
+    while (getline(stream, name, ',')) {
+        bool found = false;
+        for (const auto& entry : table) {
+            if (name == entry.first) {
+                rules |= entry.second;
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -6,9 +6,6 @@
 
 #include <PCode.hpp>
 
-// P-Code指令序列全局实例
-PCodeList pcodelist;
-
 // 指令助记符映射表
 wstring op_map[P_CODE_CNT] = {
     L"LIT",   // 加载常量
@@ -20,7 +17,13 @@ wstring op_map[P_CODE_CNT] = {
     L"JMP",   // 无条件跳转
     L"JPC",   // 条件跳转
     L"RED",   // 读取输入
-    L"WRT"    // 输出结果
+    L"WRT",   // 输出结果
+    L"STI",   // 存储常量
+    L"ADI",   // 加常量
+    L"LAI",   // 取变量加常量
+    L"INC",   // 变量原地加常量
+    L"CJP",   // 比较并条件跳转
+    L"CJI",   // 与常量比较并条件跳转
 };
 
 /**
@@ -57,6 +60,33 @@ void PCodeList::show()
         wcout << setw(4) << i << L"  " 
               << op_map[code_list[i].op] << L", " 
               << code_list[i].L << L", " 
-              << code_list[i].a << endl;
+              << code_list[i].a;
+        if (code_list[i].op >= sti && code_list[i].op != adi && code_list[i].op != cjp)
+            wcout << L", " << code_list[i].b;
+        wcout << endl;
+}
 }
+
+/**
+ * @brief 显示各过程的栈使用分析结果
+ * @details need为连同被调过程所需的栈单元数，递归或无法确定时显示为-
+ */
+void PCodeList::showFrames()
+{
+    wcout << L"entry   INT   frame   depth    need" << endl;
+    for (const FrameInfo& frame : frames) {
+        wcout << setw(5) << frame.entry << setw(6) << frame.allocAt
+              << setw(8) << frame.frameSize << setw(8) << frame.maxDepth;
+        if (frame.need > 0)
+            wcout << setw(8) << frame.need;
+        else
+            wcout << setw(8) << L"-";
+        if (frame.recursive)
+            wcout << L"  recursive";
+        wcout << endl;
+    }
+    if (stackBound > 0)
+        wcout << L"stack bound: " << stackBound << L" cells" << endl;
+    else
+        wcout << L"stack bound: unknown" << endl;
 }
@@ -7,116 +7,106 @@
 
 #include <SymTable.hpp>
 
-// 符号表全局实例
-SymTable symTable;
-
 /**
- * @brief 显示符号信息(基类)
+ * @brief 显示符号信息
+ * @param symTable 所属符号表(显示形参名称)
+ * @details 按记录标签选择过程或变量的显示格式
  */
-void Information::show()
+void Information::show(SymTable& symTable)
 {
-    wcout << setw(10) << L"cat: " << setw(5) << (int)cat
-          << setw(10) << L"offset: " << setw(5) << offset
-          << setw(10) << L"level: " << setw(5) << level;
-}
-
-/**
- * @brief 设置变量值
- * @param val 宽字符串形式的值
- */
-void VarInfo::SetValue(wstring val) 
-{ 
-    this->value = w_str2int(val); 
-}
+    if (cat == Category::PROCE) {
+        wcout << setw(10) << L"cat:" << setw(5) << (int)cat
+              << setw(10) << L"size:" << setw(5) << offset
+              << setw(10) << L"level:" << setw(5) << level
+              << setw(10) << L"entry:" << setw(5) << entry
+              << setw(17) << L"form var list:";
 
-/**
- * @brief 获取变量值
- * @return 变量当前值
- */
-int VarInfo::GetValue() 
-{ 
-    return this->value; 
+        if (formVarList == nullptr)
+            wcout << setw(5) << L"null";
+        for (FormVar* mem = formVarList; mem; mem = mem->next)
+            wcout << setw(5) << symTable.atomTable.Name(symTable.GetTable(mem->pos).name);
+    }
+    else {
+        wcout << setw(10) << L"cat:" << setw(5) << (int)cat
+              << setw(10) << L"offset:" << setw(5) << offset
+              << setw(10) << L"level:" << setw(5) << level
+              << setw(10) << L"value:" << setw(5) << value;
+    }
 }
 
 /**
- * @brief 显示变量信息
+ * @brief 设置常量值
+ * @param val 宽字符串形式的值
+ * @details 过程记录没有常量值，设置无效
  */
-void VarInfo::show()
+void Information::SetValue(const wstring& val)
 {
-    wcout << setw(10) << L"cat:" << setw(5) << (int)cat
-          << setw(10) << L"offset:" << setw(5) << offset
-          << setw(10) << L"level:" << setw(5) << level
-          << setw(10) << L"value:" << setw(5) << value;
+    if (cat != Category::PROCE)
+        this->value = w_str2int(val);
 }
 
 /**
- * @brief 获取指定位置的符号表项
- * @param num 符号表索引
- * @return 符号表项
+ * @brief 获取常量值
+ * @return 常量值，过程记录返回-1
  */
-SymTableItem SymTable::GetTable(int num)
+int Information::GetValue()
 {
-    return table.at(num);
+    return cat != Category::PROCE ? this->value : -1;
 }
 
 /**
- * @brief 过程信息构造函数
+ * @brief 设置过程入口地址
+ * @param nowEntry 入口地址
+ * @details 非过程记录没有入口地址，设置无效
  */
-ProcInfo::ProcInfo() : Information()
+void Information::SetEntry(size_t nowEntry)
 {
-    this->entry = -1;
-    this->isDefined = false;
+    if (cat == Category::PROCE)
+        this->entry = nowEntry;
 }
 
 /**
- * @brief 显示过程信息
+ * @brief 获取过程入口地址
+ * @return 入口地址，非过程记录返回-1
  */
-void ProcInfo::show()
+size_t Information::GetEntry()
 {
-    wcout << setw(10) << L"cat:" << setw(5) << (int)cat
-          << setw(10) << L"size:" << setw(5) << offset
-          << setw(10) << L"level:" << setw(5) << level
-          << setw(10) << L"entry:" << setw(5) << entry
-          << setw(17) << L"form var list:";
-    
-    if (formVarList.empty())
-        wcout << setw(5) << L"null";
-    for (size_t mem : formVarList)
-        wcout << setw(5) << symTable.GetTable(mem).name;
-}
-
-/**
- * @brief 设置过程入口地址
- * @param entry 入口地址
- */
-void ProcInfo::SetEntry(size_t entry) 
-{ 
-    this->entry = entry; 
+    return cat == Category::PROCE ? this->entry : -1;
 }
 
 /**
- * @brief 获取过程入口地址
- * @return 入口地址
+ * @brief 获取指定位置的符号表项
+ * @param num 符号表索引
+ * @return 符号表项
  */
-size_t ProcInfo::GetEntry() 
-{ 
-    return this->entry; 
+SymTableItem SymTable::GetTable(int num)
+{
+    return table.at(num);
 }
 
 /**
  * @brief 在符号表中查找符号
- * @param name 符号名称
+ * @param name 符号名称原子
  * @param cat 符号类别
  * @return 符号在表中的位置，-1表示未找到
- * @details 从当前层向外层逐层查找，返回最近的匹配项
+ * @details 从当前层向外层逐层查找，返回最近的匹配项；名称按原子比较
  */
-int SymTable::SearchInfo(wstring name, Category cat)
+int SymTable::SearchInfo(Atom name, Category cat)
 {
-    unsigned int curAddr = 0;
-    
     // 第0层为空时直接返回
     if (level == 0 && display[0] == 0)
         return -1;
+
+    return indexed ? SearchIndex(name, cat) : SearchChain(name, cat);
+}
+
+/**
+ * @brief 沿display链逐层查找符号
+ * @details 每层从链尾沿previous向前比较，耗时与可见符号数成正比
+ */
+int SymTable::SearchChain(Atom name, Category cat)
+{
+    unsigned int curAddr = 0;
     
     // 从当前层向外层遍历
     for (int i = level; i >= 0; i--) {
@@ -142,6 +132,50 @@ int SymTable::SearchInfo(wstring name, Category cat)
     return -1;
 }
 
+/**
+ * @brief 按名称索引查找符号
+ * @details 插入总在最内层进行，可见符号中最后插入的同名符号即最内层的匹配项，
+ *          索引直接给出其位置。空层的display链从表头(主程序项)开始，
+ *          因此查找主程序名时，比匹配项更内的空层会先匹配到主程序项，与逐层查找一致
+ */
+int SymTable::SearchIndex(Atom name, Category cat)
+{
+    const vector<size_t>& index = (cat == Category::PROCE) ? procIndex : identIndex;
+    size_t pos = name < index.size() ? index[name] : 0;
+
+    if (cat == Category::PROCE && !table.empty() && table[0].name == name) {
+        int outer = pos ? (int)table[pos].info->level : -1;
+        for (int i = level; i > outer; i--) {
+            if (display[i] == 0)
+                return 0;
+        }
+    }
+    return pos ? (int)pos : -1;
+}
+
+/**
+ * @brief 进入新的作用域
+ */
+void SymTable::PushDisplay()
+{
+    display.push_back(0);
+    level++;
+}
+
+/**
+ * @brief 退出当前作用域
+ * @details 沿本层链把其中的符号逐个移出名称索引，恢复被遮蔽的外层同名符号
+ */
+void SymTable::PopDisplay()
+{
+    for (size_t curAddr = display.back(); curAddr != 0; curAddr = table[curAddr].previous) {
+        vector<size_t>& index = (table[curAddr].info->cat == Category::PROCE) ? procIndex : identIndex;
+        index[table[curAddr].name] = table[curAddr].shadow;
+    }
+    display.pop_back();
+    level--;
+}
+
 /**
  * @brief 创建新的作用域
  * @details 更新sp指向新作用域的起始位置
@@ -153,11 +187,12 @@ void SymTable::MkTable()
 
 /**
  * @brief 显示符号表项信息
+ * @param symTable 所属符号表
  */
-void SymTableItem::show()
+void SymTableItem::show(SymTable& symTable)
 {
-    wcout << setw(5) << name << setw(10) << "previous:" << setw(4) << previous;
-    info->show();
+    wcout << setw(5) << symTable.atomTable.Name(name) << setw(10) << "previous:" << setw(4) << previous;
+    info->show(symTable);
     wcout << setw(10) << "display:";
     for (int i = 0; i <= info->level; i++) {
         wcout << setw(5) << symTable.display[i];
@@ -167,25 +202,25 @@ void SymTableItem::show()
 
 /**
  * @brief 向符号表插入新符号
- * @param name 符号名称
+ * @param name 符号名称原子
  * @param offset 相对偏移
  * @param cat 符号类别
  * @return 插入位置，-1表示插入失败(重复定义)
  */
-int SymTable::InsertToTable(wstring name, size_t offset, Category cat)
+int SymTable::InsertToTable(Atom name, size_t offset, Category cat)
 {
     int pos = SearchInfo(name, cat);
     
     // 检查过程名重复定义
     if (cat == Category::PROCE && pos != -1 && table[pos].info->level == level) {
-        errorHandle.error(REDECLEARED_PROC, name.c_str(), 
+        errorHandle.error(REDECLEARED_PROC, atomTable.Name(name).c_str(), 
                           lexer.GetPreWordRow(), lexer.GetPreWordCol(), 
                           lexer.GetRowPos(), lexer.GetColPos());
         return -1;
     }
     // 检查其他符号重复定义
     else if (pos != -1 && table[pos].info->level == level && cat != Category::PROCE) {
-        errorHandle.error(REDECLEARED_IDENT, name.c_str(), 
+        errorHandle.error(REDECLEARED_IDENT, atomTable.Name(name).c_str(), 
                           lexer.GetPreWordRow(), lexer.GetPreWordCol(), 
                           lexer.GetRowPos(), lexer.GetColPos());
         return -1;
@@ -197,23 +232,21 @@ int SymTable::InsertToTable(wstring name, size_t offset, Category cat)
     item.previous = display[level];
     display[level] = curAddr;
 
-    // 根据类别创建不同的信息对象
-    if (cat == Category::PROCE) {
-        ProcInfo *procInfo = new ProcInfo;
-        procInfo->cat = cat;
-        procInfo->entry = 0;
-        procInfo->offset = 0;
-        procInfo->level = level;
-        item.info = procInfo;
-    }
-    else {
-        VarInfo *varInfo = new VarInfo;
-        varInfo->offset = offset;
-        varInfo->cat = cat;
-        varInfo->level = level;
-        varInfo->SetValue(0);
-        item.info = varInfo;
-    }
+    // 登记到名称索引，遮蔽外层同名符号
+    vector<size_t>& index = (cat == Category::PROCE) ? procIndex : identIndex;
+    if (name >= index.size())
+        index.resize((size_t)name + 1, 0);
+    item.shadow = index[name];
+    index[name] = curAddr;
+
+    // 在分配区中创建信息记录
+    Information* info = infoArena.New<Information>();
+    info->cat = cat;
+    info->offset = (cat == Category::PROCE) ? 0 : offset;
+    info->level = level;
+    if (cat == Category::PROCE)
+        info->entry = 0;
+    item.info = info;
     
     table.push_back(item);
     return curAddr;
@@ -221,15 +254,16 @@ int SymTable::InsertToTable(wstring name, size_t offset, Category cat)
 
 /**
  * @brief 进入主程序
- * @param name 程序名称
+ * @param name 程序名称原子
  */
-void SymTable::EnterProgm(wstring name)
+void SymTable::EnterProgm(Atom name)
 {
     SymTableItem item;
     item.previous = 0;
+    item.shadow = 0;
     item.name = name;
     
-    ProcInfo* procInfo = new ProcInfo;
+    ProcInfo* procInfo = infoArena.New<ProcInfo>();
     procInfo->offset = 0;
     procInfo->cat = Category::PROCE;
     procInfo->level = 0;
@@ -245,7 +279,7 @@ void SymTable::showAll()
 {
     wcout << L"____________________________________________________SymTable_______________________________________________" << endl;
     for (SymTableItem mem : SymTable::table) {
-        mem.show();
+        mem.show(*this);
     }
     wcout << L"___________________________________________________________________________________________________________" << endl;
 }
@@ -258,17 +292,45 @@ void SymTable::showAll()
 void SymTable::AddWidth(size_t addr, size_t width)
 {
     table[addr].info->offset = width;
-    glo_offset = 0;
+}
+
+/**
+ * @brief 追加过程形参
+ * @param proc 过程信息
+ * @param pos 形参在符号表中的位置
+ */
+void SymTable::AddFormVar(ProcInfo* proc, size_t pos)
+{
+    FormVar* node = infoArena.New<FormVar>();
+    node->pos = pos;
+    *proc->formVarTail = node;
+    proc->formVarTail = &node->next;
+    proc->formVarCount++;
+}
+
+/**
+ * @brief 获取本次编译符号表占用的堆内存
+ * @return 符号表项、名称索引、display表与信息分配区已申请的字节数
+ */
+size_t SymTable::GetMemoryBytes()
+{
+    return table.capacity() * sizeof(SymTableItem)
+         + (procIndex.capacity() + identIndex.capacity() + display.capacity()) * sizeof(size_t)
+         + infoArena.GetReservedBytes();
 }
 
 /**
  * @brief 初始化并清空符号表
+ * @details 信息记录随分配区整体复位，不逐个释放
  */
 void SymTable::InitAndClear()
 {
     sp = 0;
     table.clear();
     display.clear();
+    procIndex.clear();
+    identIndex.clear();
+    infoArena.Reset();
     table.reserve(100);
     display.resize(1, 0);
 }
@@ -0,0 +1,143 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief 工作窃取线程池实现
+ */
+
+#include <ThreadPool.hpp>
+
+/**
+ * @brief 创建线程池
+ * @param threads 工作线程数(含调用Run的线程)，0表示使用CPU核数
+ */
+WorkStealingPool::WorkStealingPool(unsigned threads)
+    : queues(threads ? threads : max(1u, thread::hardware_concurrency())), steals(0)
+{
+    for (unsigned worker = 1; worker < queues.size(); worker++) {
+        workers.emplace_back(&WorkStealingPool::WorkerLoop, this, worker);
+    }
+}
+
+/**
+ * @brief 关闭线程池并等待各工作线程退出
+ */
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        lock_guard<mutex> guard(jobLock);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief 执行一批任务并等待全部完成
+ * @param count 任务数，任务编号为0..count-1
+ * @param task 任务函数，参数为任务编号与执行它的工作线程编号
+ * @details 同一工作线程编号同一时刻只在一个线程上执行，
+ *          任务函数可据此使用按线程划分的资源而无需加锁
+ */
+void WorkStealingPool::Run(size_t count, const Task& task)
+{
+    size_t threads = queues.size();
+    for (size_t worker = 0; worker < threads; worker++) {
+        lock_guard<mutex> guard(queues[worker].lock);
+        for (size_t i = count * worker / threads; i < count * (worker + 1) / threads; i++) {
+            queues[worker].tasks.push_back(i);
+        }
+    }
+
+    {
+        lock_guard<mutex> guard(jobLock);
+        job = &task;
+        generation++;
+        active = (unsigned)workers.size();
+    }
+    jobReady.notify_all();
+
+    Drain(0, task);
+
+    unique_lock<mutex> guard(jobLock);
+    jobDone.wait(guard, [this]() { return active == 0; });
+    job = nullptr;
+}
+
+/**
+ * @brief 工作线程主循环
+ * @param worker 工作线程编号
+ */
+void WorkStealingPool::WorkerLoop(unsigned worker)
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        const Task* task;
+        {
+            unique_lock<mutex> guard(jobLock);
+            jobReady.wait(guard, [&]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            task = job;
+        }
+
+        Drain(worker, *task);
+
+        lock_guard<mutex> guard(jobLock);
+        if (--active == 0) {
+            jobDone.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief 执行任务直到所有队列为空
+ * @param worker 工作线程编号
+ * @param task 任务函数
+ * @details 批次执行期间不会加入新任务，本队列为空且窃取失败即表示本批次已无剩余任务
+ */
+void WorkStealingPool::Drain(unsigned worker, const Task& task)
+{
+    size_t next;
+    while (Pop(worker, next) || Steal(worker, next)) {
+        task(next, worker);
+    }
+}
+
+/**
+ * @brief 从本队列队首取任务
+ */
+bool WorkStealingPool::Pop(unsigned worker, size_t& task)
+{
+    WorkQueue& queue = queues[worker];
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = queue.tasks.front();
+    queue.tasks.pop_front();
+    return true;
+}
+
+/**
+ * @brief 从其他队列队尾窃取任务
+ * @details 从下一个线程开始轮流尝试，避免所有窃取者集中于同一队列
+ */
+bool WorkStealingPool::Steal(unsigned worker, size_t& task)
+{
+    size_t threads = queues.size();
+    for (size_t i = 1; i < threads; i++) {
+        WorkQueue& queue = queues[(worker + i) % threads];
+        lock_guard<mutex> guard(queue.lock);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            steals++;
+            return true;
+        }
+    }
+    return false;
+}
@@ -5,11 +5,15 @@
  */
 
 #include <types.hpp>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HAS_SSE2 1
+#endif
 using namespace std;
 
-// 全局偏移量，用于计算变量在栈帧中的位置
-size_t glo_offset;
-
 /**
  * @brief 判断宽字符是否为数字
  * @param ch 待判断的宽字符
@@ -26,7 +30,7 @@ static bool isWDigit(wchar_t ch)
  * @return 转换后的整数值，转换失败返回0
  * @details 采用移位运算优化乘10操作: x*10 = x*8 + x*2 = (x<<3) + (x<<1)
  */
-int w_str2int(wstring numStr)
+int w_str2int(const wstring& numStr)
 {
     // 空串检查
     if (numStr.empty()) {
@@ -73,6 +77,151 @@ wstring int2w_str(int num)
     return isNegative ? L"-" + result : result;
 }
 
+/* ============================================================
+ *                 向量化ASCII检测
+ * ============================================================ */
+
+/**
+ * @brief 取掩码中最低位1的下标
+ */
+static inline unsigned int LowestBit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/**
+ * @brief 统计连续的ASCII字节数
+ * @param data 字节序列
+ * @param length 序列长度
+ * @return 从起始处开始、不含高位字节与CR的连续字节数
+ * @details 每块内将"字节 | (字节=='\r' ? 0xFF : 0)"的最高位收集为掩码，
+ *          掩码为0说明整块均可走ASCII快速路径
+ */
+size_t ScanAscii(const unsigned char* data, size_t length)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i cr32 = _mm256_set1_epi8('\r');
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned int mask = static_cast<unsigned int>(
+            _mm256_movemask_epi8(_mm256_or_si256(block, _mm256_cmpeq_epi8(block, cr32))));
+        if (mask != 0) {
+            return i + LowestBit(mask);
+        }
+    }
+#endif
+
+#if defined(HAS_SSE2)
+    const __m128i cr16 = _mm_set1_epi8('\r');
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned int mask = static_cast<unsigned int>(
+            _mm_movemask_epi8(_mm_or_si128(block, _mm_cmpeq_epi8(block, cr16))));
+        if (mask != 0) {
+            return i + LowestBit(mask);
+        }
+    }
+#endif
+
+    // 标量尾部(或不支持SIMD时的全部数据)
+    for (; i < length; ++i) {
+        if (data[i] >= 0x80 || data[i] == '\r') {
+            break;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief 统计连续的相同字节数
+ * @param data 字节序列
+ * @param length 序列长度
+ * @param byte 目标字节
+ * @return 从起始处开始、连续等于byte的字节数
+ * @details 每块与byte逐字节比较，掩码取反后最低位即第一个不同字节的位置；
+ *          用于词法分析器成块跳过连续的空行与缩进
+ */
+size_t ScanRun(const unsigned char* data, size_t length, unsigned char byte)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i target32 = _mm256_set1_epi8(static_cast<char>(byte));
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned int mask = ~static_cast<unsigned int>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, target32)));
+        if (mask != 0) {
+            return i + LowestBit(mask);
+        }
+    }
+#endif
+
+#if defined(HAS_SSE2)
+    const __m128i target16 = _mm_set1_epi8(static_cast<char>(byte));
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned int mask = ~static_cast<unsigned int>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(block, target16))) & 0xFFFF;
+        if (mask != 0) {
+            return i + LowestBit(mask);
+        }
+    }
+#endif
+
+    // 标量尾部(或不支持SIMD时的全部数据)
+    for (; i < length; ++i) {
+        if (data[i] != byte) {
+            break;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief 统计合法UTF-8的前缀字节数
+ * @param data 字节序列
+ * @param length 序列长度
+ * @param chars 输出该前缀包含的字符数
+ * @return 从起始处开始、编码合法且不含CR的连续字节数
+ */
+size_t ScanUtf8(const unsigned char* data, size_t length, size_t& chars)
+{
+    size_t i = 0;
+    chars = 0;
+    while (i < length) {
+        size_t run = ScanAscii(data + i, length - i);
+        i += run;
+        chars += run;
+        if (i == length || data[i] == '\r') {
+            break;
+        }
+
+        int charLen = calcUtf8Length(data[i]);
+        if (charLen == -1 || length - i < static_cast<size_t>(charLen)) {
+            break;
+        }
+        int k = 1;
+        while (k < charLen && (data[i + k] & 0xC0) == 0x80) {
+            k++;
+        }
+        if (k < charLen) {
+            break;
+        }
+        i += charLen;
+        chars++;
+    }
+    return i;
+}
+
 /* ============================================================
  *           ReadUnicode 类实现 (带缓冲区)
  * ============================================================ */
@@ -82,9 +231,11 @@ wstring int2w_str(int num)
  */
 ReadUnicode::ReadUnicode()
     : isFileOpen(false), reachedEnd(false), 
-      bufferStartPos(0), bufferLength(0), totalCharsLoaded(0)
+      loadedLength(0), retainChunks(RETAIN_ALL), firstRetained(0), totalCharsLoaded(0),
+      backend(BACKEND_STREAM), hFile(INVALID_HANDLE_VALUE), hMapping(NULL),
+      mapView(nullptr), mapBegin(nullptr), mapEnd(nullptr),
+      isDirect(false), rawCursor(nullptr), rawEnd(nullptr), log(&wcout)
 {
-    memset(buffer, 0, sizeof(buffer));
 }
 
 /**
@@ -95,6 +246,8 @@ ReadUnicode::~ReadUnicode()
     if (file.is_open()) {
         file.close();
     }
+    unmapFile();
+    releaseChunks();
 }
 
 /**
@@ -105,12 +258,56 @@ void ReadUnicode::InitReadUnicode()
     if (file.is_open()) {
         file.close();
     }
+    unmapFile();
+    backend = BACKEND_STREAM;
     isFileOpen = false;
     reachedEnd = false;
-    bufferStartPos = 0;
-    bufferLength = 0;
+    loadedLength = 0;
+    firstRetained = 0;
     totalCharsLoaded = 0;
-    memset(buffer, 0, sizeof(buffer));
+    rawCursor = rawEnd = nullptr;
+    releaseChunks();
+}
+
+/**
+ * @brief 设置回看窗口
+ * @param chars 当前加载位置之前至少保留的字符数，RETAIN_ALL表示全部保留
+ * @details 窗口按块向上取整且至少保留一块，保证跨块回退总是可用
+ */
+void ReadUnicode::SetRetention(size_t chars)
+{
+    retainChunks = (chars == RETAIN_ALL) ? RETAIN_ALL : (chars + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (chars != RETAIN_ALL && retainChunks == 0) {
+        retainChunks = 1;
+    }
+}
+
+/**
+ * @brief 分配一块存储，优先复用已回收的块
+ */
+wchar_t* ReadUnicode::allocChunk()
+{
+    if (!freeChunks.empty()) {
+        wchar_t* chunk = freeChunks.back();
+        freeChunks.pop_back();
+        return chunk;
+    }
+    return new wchar_t[CHUNK_SIZE];
+}
+
+/**
+ * @brief 释放全部块(含复用池)
+ */
+void ReadUnicode::releaseChunks()
+{
+    for (wchar_t* chunk : chunks) {
+        delete[] chunk;
+    }
+    for (wchar_t* chunk : freeChunks) {
+        delete[] chunk;
+    }
+    chunks.clear();
+    freeChunks.clear();
 }
 
 /**
@@ -118,7 +315,7 @@ void ReadUnicode::InitReadUnicode()
  * @param byte UTF-8首字节
  * @return 编码长度(1-4)，非法返回-1
  */
-int ReadUnicode::calcUtf8Length(unsigned char byte)
+int calcUtf8Length(unsigned char byte)
 {
     if (byte < 0x80)        return 1;  // 0xxxxxxx - ASCII
     if (byte < 0xC0)        return -1; // 10xxxxxx - 非法首字节
@@ -129,62 +326,92 @@ int ReadUnicode::calcUtf8Length(unsigned char byte)
 }
 
 /**
- * @brief 从文件读取并解码一个UTF-8字符
- * @param outChar 输出的宽字符
- * @return 成功返回true，失败或EOF返回false
- * @details 自动跳过回车符(CR)，处理Windows换行
+ * @brief 流式后端补充原始字节
+ * @return 读到新字节返回true，文件结束或映射后端返回false
+ * @details 未解码完的剩余字节(不完整的多字节序列)移到缓冲区头部后续读
  */
-bool ReadUnicode::readOneChar(wchar_t& outChar)
+bool ReadUnicode::fillRawBuffer()
 {
-    int byte;
-    
-    // 读取字节，跳过回车符(处理Windows的\r\n)
-    do {
-        byte = file.get();
-        if (byte == EOF) {
-            return false;  // 文件结束
-        }
-    } while (byte == '\r');  // 跳过回车符
-    
-    unsigned char firstByte = static_cast<unsigned char>(byte);
-    int charLen = calcUtf8Length(firstByte);
-    
-    if (charLen == -1) {
-        wcout << L"[Error] Invalid UTF-8 byte: 0x" << hex << (int)firstByte << dec << endl;
+    if (backend == BACKEND_MAPPING || !file.is_open()) {
         return false;
     }
-    
-    // 单字节ASCII字符
-    if (charLen == 1) {
-        outChar = firstByte;
-        return true;
+
+    size_t remain = rawEnd - rawCursor;
+    if (remain > 0) {
+        memmove(rawBuffer, rawCursor, remain);
     }
-    
-    // 多字节UTF-8字符
-    wchar_t codepoint = firstByte & (0xFF >> (charLen + 1));
-    
-    for (int i = 1; i < charLen; ++i) {
-        byte = file.get();
-        if (byte == EOF) {
-            wcout << L"[Error] Incomplete UTF-8 sequence" << endl;
-            return false;
+    file.read(reinterpret_cast<char*>(rawBuffer) + remain, RAW_BUFFER_SIZE - remain);
+    size_t got = static_cast<size_t>(file.gcount());
+
+    rawCursor = rawBuffer;
+    rawEnd = rawBuffer + remain + got;
+    return got > 0;
+}
+
+/**
+ * @brief 批量校验并解码UTF-8字节
+ * @param out 输出字符缓冲区
+ * @param outCap 最多输出的字符数
+ * @param outLen 实际输出的字符数
+ * @return 解码状态
+ * @details 连续的ASCII字节经ScanAscii整块识别后直接展宽复制；
+ *          多字节字符逐个校验后续字节(10xxxxxx)并解码；
+ *          回车符(CR)被跳过，以处理Windows换行
+ */
+DecodeStatus ReadUnicode::decodeBlock(wchar_t* out, size_t outCap, size_t& outLen)
+{
+    outLen = 0;
+
+    while (rawCursor < rawEnd && outLen < outCap) {
+        // ASCII快速路径
+        size_t run = ScanAscii(rawCursor, min<size_t>(rawEnd - rawCursor, outCap - outLen));
+        for (size_t i = 0; i < run; ++i) {
+            out[outLen + i] = rawCursor[i];
+        }
+        rawCursor += run;
+        outLen += run;
+        if (rawCursor == rawEnd || outLen == outCap) {
+            break;
+        }
+
+        // 跳过回车符
+        unsigned char firstByte = *rawCursor;
+        if (firstByte == '\r') {
+            rawCursor++;
+            continue;
         }
-        unsigned char contByte = static_cast<unsigned char>(byte);
-        // 验证后续字节格式 (10xxxxxx)
-        if ((contByte & 0xC0) != 0x80) {
-            wcout << L"[Error] Invalid UTF-8 continuation byte" << endl;
-            return false;
+
+        int charLen = calcUtf8Length(firstByte);
+        if (charLen == -1) {
+            *log << L"[Error] Invalid UTF-8 byte: 0x" << hex << (int)firstByte << dec << endl;
+            return DECODE_INVALID;
+        }
+        if (rawEnd - rawCursor < charLen) {
+            return DECODE_PARTIAL;
+        }
+
+        // 多字节UTF-8字符
+        wchar_t codepoint = firstByte & (0xFF >> (charLen + 1));
+        for (int i = 1; i < charLen; ++i) {
+            unsigned char contByte = rawCursor[i];
+            // 验证后续字节格式 (10xxxxxx)
+            if ((contByte & 0xC0) != 0x80) {
+                *log << L"[Error] Invalid UTF-8 continuation byte" << endl;
+                return DECODE_INVALID;
+            }
+            codepoint = (codepoint << 6) | (contByte & 0x3F);
         }
-        codepoint = (codepoint << 6) | (contByte & 0x3F);
+        rawCursor += charLen;
+        out[outLen++] = codepoint;
     }
-    
-    outChar = codepoint;
-    return true;
+
+    return DECODE_OK;
 }
 
 /**
- * @brief 加载下一块缓冲区
- * @return 成功加载返回true，到达文件末尾返回false
+ * @brief 加载下一块
+ * @return 成功加载返回true，已到达文件末尾返回false
+ * @details 新块追加在已加载内容之后；超出回看窗口的旧块被回收
  */
 bool ReadUnicode::loadNextBuffer()
 {
@@ -192,53 +419,178 @@ bool ReadUnicode::loadNextBuffer()
         return false;
     }
     
-    // 更新缓冲区起始位置
-    bufferStartPos += bufferLength;
-    bufferLength = 0;
-    memset(buffer, 0, sizeof(buffer));
+    wchar_t* chunk = allocChunk();
+    size_t startPos = loadedLength;
+    size_t length = 0;
+    chunks.push_back(chunk);
     
-    // 填充缓冲区
-    wchar_t ch;
-    while (bufferLength < BUFFER_SIZE - 1) {  // 保留1个位置给结束符
-        if (!readOneChar(ch)) {
-            // 文件结束，添加结束标记
+    // 填充整块
+    while (length < CHUNK_SIZE) {
+        size_t decoded = 0;
+        DecodeStatus status = decodeBlock(chunk + length, CHUNK_SIZE - length, decoded);
+        length += decoded;
+        totalCharsLoaded += decoded;
+        if (length == CHUNK_SIZE) {
+            break;
+        }
+
+        // 非法字节，或字节耗尽且无法补充: 文件结束，添加结束标记
+        if (status == DECODE_INVALID || !fillRawBuffer()) {
+            if (status == DECODE_PARTIAL) {
+                *log << L"[Error] Incomplete UTF-8 sequence" << endl;
+            }
             reachedEnd = true;
-            buffer[bufferLength++] = L'#';
-            wcout << L"[Info] End of file reached, total " << totalCharsLoaded << L" characters loaded" << endl;
+            chunk[length++] = L'#';
+            *log << L"[Info] End of file reached, total " << totalCharsLoaded << L" characters loaded" << endl;
             break;
         }
-        buffer[bufferLength++] = ch;
-        totalCharsLoaded++;
     }
+    loadedLength += length;
     
-    if (bufferLength > 0 && !reachedEnd) {
-        wcout << L"[Info] Buffer loaded: pos " << bufferStartPos 
-              << L" - " << (bufferStartPos + bufferLength - 1) << endl;
+    if (!reachedEnd) {
+        *log << L"[Info] Buffer loaded: pos " << startPos 
+              << L" - " << (loadedLength - 1) << endl;
+    }
+
+    // 淘汰回看窗口之外的块
+    if (retainChunks != RETAIN_ALL) {
+        size_t current = chunks.size() - 1;
+        while (firstRetained + retainChunks < current) {
+            freeChunks.push_back(chunks[firstRetained]);
+            chunks[firstRetained++] = nullptr;
+        }
     }
     
-    return bufferLength > 0;
+    return length > 0;
+}
+
+/**
+ * @brief 加载直到覆盖指定位置
+ * @param pos 请求的字符位置
+ * @return 该位置的字符，文件结束后仍未覆盖返回'\0'
+ */
+wchar_t ReadUnicode::loadUntil(const size_t pos)
+{
+    while (pos >= loadedLength) {
+        if (!loadNextBuffer()) {
+            return L'\0';
+        }
+    }
+    const wchar_t* chunk = chunks[pos >> CHUNK_SHIFT];
+    return chunk ? chunk[pos & CHUNK_MASK] : L'\0';
+}
+
+/**
+ * @brief 将整个文件映射到内存
+ * @param filename 源文件路径
+ * @return 映射成功返回true；文件为空或映射失败返回false
+ * @details 原地跳过BOM，并检查内容是否为合法UTF-8且不含CR，
+ *          满足时无需解码，可直接按字节访问
+ */
+bool ReadUnicode::mapFile(const string& filename)
+{
+    hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0) {
+        unmapFile();
+        return false;
+    }
+
+    hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping == NULL) {
+        unmapFile();
+        return false;
+    }
+
+    mapView = static_cast<const unsigned char*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (mapView == nullptr) {
+        unmapFile();
+        return false;
+    }
+
+    mapBegin = mapView;
+    mapEnd = mapView + static_cast<size_t>(fileSize.QuadPart);
+
+    // 原地跳过UTF-8 BOM (0xEF 0xBB 0xBF)
+    if (mapEnd - mapBegin >= 3 && mapBegin[0] == 0xEF && mapBegin[1] == 0xBB && mapBegin[2] == 0xBF) {
+        mapBegin += 3;
+        *log << L"[Info] UTF-8 BOM detected, skipped" << endl;
+    }
+    rawCursor = mapBegin;
+    rawEnd = mapEnd;
+
+    // 合法UTF-8且不含CR时可直接访问
+    size_t length = mapEnd - mapBegin;
+    size_t chars = 0;
+    isDirect = ScanUtf8(mapBegin, length, chars) == length;
+    if (isDirect) {
+        totalCharsLoaded = chars;
+    }
+    return true;
+}
+
+/**
+ * @brief 解除文件映射并关闭句柄
+ */
+void ReadUnicode::unmapFile()
+{
+    if (mapView != nullptr) {
+        UnmapViewOfFile(mapView);
+    }
+    if (hMapping != NULL) {
+        CloseHandle(hMapping);
+    }
+    if (hFile != INVALID_HANDLE_VALUE) {
+        CloseHandle(hFile);
+    }
+    hFile = INVALID_HANDLE_VALUE;
+    hMapping = NULL;
+    mapView = mapBegin = mapEnd = nullptr;
+    isDirect = false;
 }
 
 /**
  * @brief 打开UTF-8文件并初始化缓冲区
  * @param filename 源文件路径
+ * @param mode 读取后端，映射失败(如空文件)时自动退回流式读取
  */
-void ReadUnicode::readFile2USC2(string filename)
+void ReadUnicode::readFile2USC2(string filename, SourceBackend mode)
 {
     // 先重置状态
     InitReadUnicode();
     
-    wcout << L"[Info] Opening file: " << filename.c_str() << endl;
+    *log << L"[Info] Opening file: " << filename.c_str() << endl;
+
+    if (mode == BACKEND_MAPPING && mapFile(filename)) {
+        backend = BACKEND_MAPPING;
+        isFileOpen = true;
+        *log << L"[Info] Compiling '" << filename.c_str() << L"' ..." << endl;
+
+        if (isDirect) {
+            // 直接访问: 无需解码，整个文件即视为已加载
+            reachedEnd = true;
+            *log << L"[Info] End of file reached, total " << totalCharsLoaded << L" characters loaded" << endl;
+        }
+        else {
+            loadNextBuffer();
+        }
+        return;
+    }
 
     // 使用二进制模式打开以正确处理UTF-8编码
     file.open(filename, ios::in | ios::binary);
     if (!file.is_open()) {
-        wcout << L"[Error] Failed to open file: " << filename.c_str() << endl;
+        *log << L"[Error] Failed to open file: " << filename.c_str() << endl;
         return;
     }
     
     isFileOpen = true;
-    wcout << L"[Info] Compiling '" << filename.c_str() << L"' ..." << endl;
+    *log << L"[Info] Compiling '" << filename.c_str() << L"' ..." << endl;
     
     // 检测并跳过UTF-8 BOM (0xEF 0xBB 0xBF)
     int b1 = file.get();
@@ -246,9 +598,10 @@ void ReadUnicode::readFile2USC2(string filename)
     int b3 = file.get();
     
     if (b1 == 0xEF && b2 == 0xBB && b3 == 0xBF) {
-        wcout << L"[Info] UTF-8 BOM detected, skipped" << endl;
+        *log << L"[Info] UTF-8 BOM detected, skipped" << endl;
     } else {
         // 不是BOM，回到文件开头
+        file.clear();
         file.seekg(0, ios::beg);
     }
     
@@ -257,44 +610,39 @@ void ReadUnicode::readFile2USC2(string filename)
 }
 
 /**
- * @brief 获取指定位置的字符
- * @param pos 字符在源程序中的全局位置(从0开始)
- * @return 指定位置的宽字符，无效位置返回'\0'
- * @details 如果请求位置不在当前缓冲区内，自动加载新的缓冲区
+ * @brief 判断源程序是否为空
+ * @return true表示为空或未打开文件
  */
-wchar_t ReadUnicode::getProgmWStr(const size_t pos)
+bool ReadUnicode::isEmpty()
 {
-    // 检查是否在当前缓冲区范围内
-    if (pos >= bufferStartPos && pos < bufferStartPos + bufferLength) {
-        return buffer[pos - bufferStartPos];
-    }
-    
-    // 请求位置在缓冲区之后，需要加载新缓冲区
-    if (pos >= bufferStartPos + bufferLength && !reachedEnd) {
-        // 循环加载直到找到目标位置或文件结束
-        while (pos >= bufferStartPos + bufferLength && !reachedEnd) {
-            if (!loadNextBuffer()) {
-                break;
-            }
-        }
-        
-        // 再次检查是否在新缓冲区内
-        if (pos >= bufferStartPos && pos < bufferStartPos + bufferLength) {
-            return buffer[pos - bufferStartPos];
-        }
+    if (isDirect) return false;
+    return !isFileOpen || (loadedLength == 0 && reachedEnd);
+}
+
+/**
+ * @brief 判断指定位置是否仍可访问
+ * @param pos 字符位置
+ * @return 已加载且未被淘汰返回true
+ */
+bool ReadUnicode::IsRetained(const size_t pos)
+{
+    if (isDirect) {
+        return pos <= static_cast<size_t>(mapEnd - mapBegin);
     }
-    
-    // 位置无效或已到文件末尾
-    return L'\0';
+    return pos < loadedLength && chunks[pos >> CHUNK_SHIFT] != nullptr;
 }
 
 /**
- * @brief 判断源程序是否为空
- * @return true表示为空或未打开文件
+ * @brief 获取分块存储占用的字节数
+ * @return 在用块与复用池中块的总字节数
  */
-bool ReadUnicode::isEmpty()
+size_t ReadUnicode::GetRetainedBytes()
 {
-    return !isFileOpen || (bufferLength == 0 && reachedEnd);
+    size_t live = 0;
+    for (size_t i = firstRetained; i < chunks.size(); i++) {
+        if (chunks[i]) live++;
+    }
+    return (live + freeChunks.size()) * CHUNK_SIZE * sizeof(wchar_t);
 }
 
 /**
@@ -305,6 +653,3 @@ size_t ReadUnicode::getLoadedCount()
 {
     return totalCharsLoaded;
 }
-
-// Unicode读取器全局实例
-ReadUnicode readUnicode;
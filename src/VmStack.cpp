@@ -0,0 +1,82 @@
+/**
+ * @file VmStack.cpp
+ * @brief 固定容量运行时栈实现
+ */
+
+#include <VmStack.hpp>
+
+/**
+ * @brief 申请固定容量的栈
+ * @param cells 存储单元数
+ * @param request 请求的选项(STACK_*)
+ * @return 申请成功返回true
+ * @details 请求大页但系统不支持或没有权限时退回普通页，可由Flags()查看实际生效的选项
+ */
+bool VmStack::Allocate(size_t cells, unsigned request)
+{
+    Release();
+    if (cells == 0) {
+        return false;
+    }
+    size_t need = cells * sizeof(int);
+
+    if (request == 0) {
+        base = new (nothrow) int[cells]();
+        capacity = base ? cells : 0;
+        return base != nullptr;
+    }
+
+    if (request & STACK_HUGE_PAGES) {
+        size_t large = GetLargePageMinimum();
+        if (large != 0) {
+            size_t total = (need + large - 1) / large * large;
+            void* p = VirtualAlloc(nullptr, total, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (p != nullptr) {
+                base = (int*)p;
+                bytes = total;
+                capacity = total / sizeof(int);
+                flags = STACK_HUGE_PAGES;
+                return true;
+            }
+        }
+    }
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t page = info.dwPageSize;
+    size_t total = (need + page - 1) / page * page;
+    size_t guard = (request & STACK_GUARD) ? page : 0;
+    void* p = VirtualAlloc(nullptr, total + guard, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (p == nullptr) {
+        return false;
+    }
+    if (guard) {
+        DWORD old;
+        if (VirtualProtect((char*)p + total, guard, PAGE_NOACCESS, &old)) {
+            flags |= STACK_GUARD;
+        }
+    }
+    base = (int*)p;
+    bytes = total + guard;
+    capacity = total / sizeof(int);
+    return true;
+}
+
+/**
+ * @brief 释放栈空间
+ */
+void VmStack::Release()
+{
+    if (base != nullptr) {
+        if (bytes != 0) {
+            VirtualFree(base, 0, MEM_RELEASE);
+        }
+        else {
+            delete[] base;
+        }
+    }
+    base = nullptr;
+    capacity = 0;
+    bytes = 0;
+    flags = 0;
+}
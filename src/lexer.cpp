@@ -7,6 +7,242 @@
 
 #include <lexer.hpp>
 
+/* ============================================================
+ *                 保留字完美哈希表 (编译期生成)
+ * ============================================================ */
+
+/**
+ * @struct Keyword
+ * @brief 保留字表项
+ */
+struct Keyword
+{
+    const wchar_t* word;      // 保留字
+    size_t length;            // 长度
+    unsigned long type;       // 词法单元类型
+};
+
+const size_t KEYWORD_HASH_SIZE = 32;    // 哈希表槽数
+const size_t KEYWORD_MIN_LEN = 2;       // 最短保留字长度
+const size_t KEYWORD_MAX_LEN = 9;       // 最长保留字长度
+
+// 保留字表
+static constexpr Keyword KEYWORDS[RSV_WORD_MAX] = {
+    { L"odd", 3, ODD_SYM },       { L"begin", 5, BEGIN_SYM },   { L"end", 3, END_SYM },
+    { L"if", 2, IF_SYM },         { L"then", 4, THEN_SYM },     { L"while", 5, WHILE_SYM },
+    { L"do", 2, DO_SYM },         { L"call", 4, CALL_SYM },     { L"const", 5, CONST_SYM },
+    { L"var", 3, VAR_SYM },       { L"procedure", 9, PROC_SYM },{ L"write", 5, WRITE_SYM },
+    { L"read", 4, READ_SYM },     { L"program", 7, PROGM_SYM }, { L"else", 4, ELSE_SYM }
+};
+
+/**
+ * @brief 保留字哈希函数
+ * @details 由长度与前两个字符计算；末字符无法区分while与write，故取第二个字符
+ */
+static constexpr size_t KeywordHash(size_t length, wchar_t first, wchar_t second)
+{
+    return (length + (first & 31) * 5 + (second & 31) * 7) & (KEYWORD_HASH_SIZE - 1);
+}
+
+/**
+ * @struct KeywordTable
+ * @brief 保留字哈希表，collisions记录构造时的冲突数
+ */
+struct KeywordTable
+{
+    Keyword slot[KEYWORD_HASH_SIZE];
+    size_t collisions;
+};
+
+/**
+ * @brief 编译期构造保留字哈希表
+ */
+static constexpr KeywordTable BuildKeywordTable()
+{
+    KeywordTable table = {};
+    for (int i = 0; i < RSV_WORD_MAX; i++) {
+        size_t h = KeywordHash(KEYWORDS[i].length, KEYWORDS[i].word[0], KEYWORDS[i].word[1]);
+        if (table.slot[h].word) {
+            table.collisions++;
+        }
+        else {
+            table.slot[h] = KEYWORDS[i];
+        }
+    }
+    return table;
+}
+
+static constexpr KeywordTable keywordTable = BuildKeywordTable();
+static_assert(keywordTable.collisions == 0, "keyword hash must be collision-free");
+
+/**
+ * @brief 查找保留字
+ * @param word 单词字符序列
+ * @param length 单词长度
+ * @return 保留字对应的词法单元类型，不是保留字返回IDENT
+ */
+unsigned long LookupKeyword(const wchar_t* word, size_t length)
+{
+    if (length < KEYWORD_MIN_LEN || length > KEYWORD_MAX_LEN) {
+        return IDENT;
+    }
+    const Keyword& entry = keywordTable.slot[KeywordHash(length, word[0], word[1])];
+    if (entry.length != length || wmemcmp(entry.word, word, length) != 0) {
+        return IDENT;
+    }
+    return entry.type;
+}
+
+/* ============================================================
+ *               DFA扫描表 (字符类表与状态转移表)
+ * ============================================================ */
+
+/**
+ * @enum CharClass
+ * @brief 字符类，非ASCII字符一律归为CC_OTHER
+ */
+enum CharClass : unsigned char {
+    CC_OTHER, CC_LETTER, CC_DIGIT, CC_SPACE, CC_NEWLINE, CC_HASH, CC_END,
+    CC_COLON, CC_LT, CC_GT, CC_EQ, CC_PLUS, CC_MINUS, CC_STAR, CC_SLASH,
+    CC_LPAREN, CC_RPAREN, CC_COMMA, CC_SEMI,
+    CC_COUNT
+};
+
+/**
+ * @enum DfaState
+ * @brief DFA状态，DS_COUNT之后为终止动作
+ */
+enum DfaState : unsigned char {
+    DS_START, DS_IDENT, DS_NUMBER, DS_COLON, DS_LT, DS_GT,
+    DS_COUNT,
+    DS_ACCEPT = DS_COUNT,   // 接受，当前字符属于词法单元
+    DS_RETRACT,             // 接受，当前字符为超前读入的字符
+    DS_ERROR                // 错误，交由逐字符扫描报告
+};
+
+/**
+ * @struct CharClassTable
+ * @brief ASCII字符到字符类的映射
+ */
+struct CharClassTable
+{
+    unsigned char cls[128];
+};
+
+/**
+ * @struct DfaTable
+ * @brief 状态转移表，type记录终止动作对应的词法单元类型
+ */
+struct DfaTable
+{
+    unsigned char next[DS_COUNT][CC_COUNT];
+    unsigned long type[DS_COUNT][CC_COUNT];
+};
+
+/**
+ * @brief 编译期构造字符类表
+ */
+static constexpr CharClassTable BuildCharClassTable()
+{
+    CharClassTable table = {};
+    for (int c = 'a'; c <= 'z'; c++) table.cls[c] = CC_LETTER;
+    for (int c = 'A'; c <= 'Z'; c++) table.cls[c] = CC_LETTER;
+    for (int c = '0'; c <= '9'; c++) table.cls[c] = CC_DIGIT;
+    table.cls[' '] = CC_SPACE;    table.cls['\t'] = CC_SPACE;
+    table.cls['\n'] = CC_NEWLINE; table.cls['#'] = CC_HASH;     table.cls[0] = CC_END;
+    table.cls[':'] = CC_COLON;    table.cls['<'] = CC_LT;       table.cls['>'] = CC_GT;
+    table.cls['='] = CC_EQ;       table.cls['+'] = CC_PLUS;     table.cls['-'] = CC_MINUS;
+    table.cls['*'] = CC_STAR;     table.cls['/'] = CC_SLASH;    table.cls['('] = CC_LPAREN;
+    table.cls[')'] = CC_RPAREN;   table.cls[','] = CC_COMMA;    table.cls[';'] = CC_SEMI;
+    return table;
+}
+
+/**
+ * @brief 编译期构造状态转移表
+ * @details 与GetWord的逐字符扫描逐一对应：标识符与数字读到非法字符后回退，
+ *          ':'后非'='、数字后紧跟字母等出错情形转为DS_ERROR
+ */
+static constexpr DfaTable BuildDfaTable()
+{
+    DfaTable table = {};
+    for (int s = 0; s < DS_COUNT; s++) {
+        for (int c = 0; c < CC_COUNT; c++) {
+            table.next[s][c] = DS_ERROR;
+            table.type[s][c] = NUL;
+        }
+    }
+
+    // 起始状态: 多字符词法单元进入对应状态，单字符运算符直接接受
+    table.next[DS_START][CC_LETTER] = DS_IDENT;
+    table.next[DS_START][CC_DIGIT] = DS_NUMBER;
+    table.next[DS_START][CC_COLON] = DS_COLON;
+    table.next[DS_START][CC_LT] = DS_LT;
+    table.next[DS_START][CC_GT] = DS_GT;
+    const unsigned char singles[] = { CC_EQ, CC_PLUS, CC_MINUS, CC_STAR, CC_SLASH,
+                                      CC_LPAREN, CC_RPAREN, CC_COMMA, CC_SEMI };
+    const unsigned long singleTypes[] = { EQL, PLUS, MINUS, MULTI, DIVIS,
+                                          LPAREN, RPAREN, COMMA, SEMICOLON };
+    for (int i = 0; i < 9; i++) {
+        table.next[DS_START][singles[i]] = DS_ACCEPT;
+        table.type[DS_START][singles[i]] = singleTypes[i];
+    }
+
+    // 标识符、数字、'<'、'>': 默认回退超前字符并接受
+    for (int c = 0; c < CC_COUNT; c++) {
+        table.next[DS_IDENT][c] = DS_RETRACT;   table.type[DS_IDENT][c] = IDENT;
+        table.next[DS_NUMBER][c] = DS_RETRACT;  table.type[DS_NUMBER][c] = NUMBER;
+        table.next[DS_LT][c] = DS_RETRACT;      table.type[DS_LT][c] = LSS;
+        table.next[DS_GT][c] = DS_RETRACT;      table.type[DS_GT][c] = GRT;
+    }
+    table.next[DS_IDENT][CC_LETTER] = DS_IDENT;
+    table.next[DS_IDENT][CC_DIGIT] = DS_IDENT;
+    table.next[DS_NUMBER][CC_DIGIT] = DS_NUMBER;
+    table.next[DS_NUMBER][CC_LETTER] = DS_ERROR;
+
+    // 双字符运算符
+    table.next[DS_COLON][CC_EQ] = DS_ACCEPT;    table.type[DS_COLON][CC_EQ] = ASSIGN;
+    table.next[DS_LT][CC_EQ] = DS_ACCEPT;       table.type[DS_LT][CC_EQ] = LEQ;
+    table.next[DS_LT][CC_GT] = DS_ACCEPT;       table.type[DS_LT][CC_GT] = NEQ;
+    table.next[DS_GT][CC_EQ] = DS_ACCEPT;       table.type[DS_GT][CC_EQ] = GEQ;
+    return table;
+}
+
+static constexpr CharClassTable charClass = BuildCharClassTable();
+static constexpr DfaTable dfa = BuildDfaTable();
+
+/**
+ * @brief 获取字符的字符类
+ */
+static inline unsigned char ClassOf(wchar_t c)
+{
+    return static_cast<unsigned int>(c) < 128 ? charClass.cls[c] : static_cast<unsigned char>(CC_OTHER);
+}
+
+/**
+ * @brief 按字符源中的位置查找保留字
+ * @param source 字符源
+ * @param start 单词首字符位置
+ * @param length 单词长度
+ * @return 保留字对应的词法单元类型，不是保留字返回IDENT
+ */
+template <typename Source>
+static unsigned long MatchKeyword(const Source& source, size_t start, size_t length)
+{
+    if (length < KEYWORD_MIN_LEN || length > KEYWORD_MAX_LEN) {
+        return IDENT;
+    }
+    const Keyword& entry = keywordTable.slot[KeywordHash(length, source(start), source(start + 1))];
+    if (entry.length != length) {
+        return IDENT;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (entry.word[i] != source(start + i)) {
+            return IDENT;
+        }
+    }
+    return entry.type;
+}
+
 /**
  * @brief 初始化词法分析器
  * @details 重置所有状态变量，初始化符号映射表
@@ -14,14 +250,17 @@
 void Lexer::InitLexer()
 {
     // 状态变量初始化
-    ch = L' ';
-    tokenType = NUL;
-    strToken = L"";
-    colPos = 0;
-    rowPos = 1;
-    preWordCol = 0;
-    preWordRow = 1;
-    nowPtr = 0;
+    StopPipeline();
+    ResetScan();
+    atoms->Clear();
+    lineStarts.assign(1, 0);
+    tokens.clear();
+    diags.clear();
+    tokensEnd = 0;
+    tokenCursor = 0;
+    diagCursor = 0;
+    deferring = false;
+    replaying = false;
 
     // 符号类型到名称的映射表
     sym_map[NUL] = L"NUL";
@@ -59,6 +298,27 @@ void Lexer::InitLexer()
     sym_map[ELSE_SYM] = L"ELSE_SYM";
 }
 
+/**
+ * @brief 重置扫描位置与状态
+ * @details 回到源程序开头；行首索引与词法单元序列保持不变
+ */
+void Lexer::ResetScan()
+{
+    ch = L' ';
+    chStart = 0;
+    tokenType = NUL;
+    strToken.clear();
+    tokenStart = 0;
+    tokenLength = 0;
+    tokenPending = false;
+    tokenAtom = NO_ATOM;
+    colPos = 0;
+    rowPos = 1;
+    preWordCol = 0;
+    preWordRow = 1;
+    nowPtr = 0;
+}
+
 /**
  * @brief 判断当前字符是否为数字
  * @return true表示是数字，false表示不是
@@ -103,15 +363,45 @@ int Lexer::IsOperator()
     return -1;
 }
 
+/**
+ * @brief 读取源程序指定位置的字符
+ * @param pos 字符位置
+ * @return 该位置的字符，文件末尾为'#'，越界为'\0'；分块扫描时块结束处为'\0'
+ * @details 映射后端可直接访问时按指针取字符，否则经由getProgmWStr
+ */
+inline wchar_t Lexer::SourceAt(size_t pos)
+{
+    const unsigned char* data = reader->GetDirectData();
+    if (data) {
+        size_t length = reader->GetDirectLength();
+        if (chunkEnd < length) {
+            return pos < chunkEnd ? data[pos] : L'\0';
+        }
+        if (pos < length) return data[pos];
+        return pos == length ? L'#' : L'\0';
+    }
+    return reader->getProgmWStr(pos);
+}
+
 /**
  * @brief 读取下一个字符
- * @details 从源程序中读取下一个字符，更新位置指针
+ * @details 从源程序中读取下一个字符，更新位置指针；
+ *          直接访问UTF-8源程序时多字节字符整体读入，列号按字符计
  */
 void Lexer::GetChar()
 {
-    ch = readUnicode.getProgmWStr(nowPtr);
+    chStart = nowPtr;
+    ch = SourceAt(nowPtr);
     nowPtr++;
     colPos++;
+    if (ch >= 0x80) {
+        const unsigned char* data = reader->GetDirectData();
+        if (data) {
+            size_t bytes;
+            ch = DecodeUtf8(data + chStart, bytes);
+            nowPtr = chStart + bytes;
+        }
+    }
 }
 
 /**
@@ -120,21 +410,21 @@ void Lexer::GetChar()
  */
 void Lexer::GetBC()
 {
-    while (readUnicode.getProgmWStr(nowPtr) && 
-           (readUnicode.getProgmWStr(nowPtr) == L' ' || 
-            readUnicode.getProgmWStr(nowPtr) == L'\t')) {
+    wchar_t next = SourceAt(nowPtr);
+    while (next == L' ' || next == L'\t') {
         GetChar();
+        next = SourceAt(nowPtr);
     }
 }
 
 /**
  * @brief 回退一个字符
- * @details 将读取指针回退一位，用于超前搜索后的回退
+ * @details 将读取指针退回到刚读入字符的位置，用于超前搜索后的回退；
+ *          当前字符仍为该字符
  */
 void Lexer::Retract()
 {
-    nowPtr--;
-    ch = readUnicode.getProgmWStr(nowPtr);
+    nowPtr = chStart;
     colPos--;
 }
 
@@ -147,25 +437,710 @@ void Lexer::Concat()
 }
 
 /**
- * @brief 查找保留字表
- * @return 保留字索引，-1表示不是保留字
+ * @brief 记录行首位置
+ * @details 在读过换行符后调用，此时nowPtr指向下一行首字符；
+ *          回退后重读同一换行符时不会重复记录
  */
-int Lexer::Reserve()
+void Lexer::RecordLine()
 {
-    for (int i = 0; i < RSV_WORD_MAX; i++) {
-        if (resv_table[i] == strToken) {
-            return i;
+    if (nowPtr > lineStarts.back()) {
+        lineStarts.push_back(nowPtr);
+    }
+}
+
+/**
+ * @brief 按记录的位置生成strToken
+ * @details DFA扫描只记录词法单元的位置与长度，需要字符串时才生成，
+ *          保留字与运算符通常无需生成
+ */
+void Lexer::MaterializeToken()
+{
+    const unsigned char* data = reader->GetDirectData();
+    strToken.resize(tokenLength);
+    size_t pos = tokenStart;
+    for (size_t i = 0; i < tokenLength; i++) {
+        wchar_t c = SourceAt(pos);
+        size_t bytes = 1;
+        if (c >= 0x80 && data) {
+            c = DecodeUtf8(data + pos, bytes);
         }
+        strToken[i] = c;
+        pos += bytes;
     }
-    return -1;
+    tokenPending = false;
+}
+
+/**
+ * @brief 报告词法错误
+ * @param n 错误类型
+ * @param extra 附加信息
+ * @details 整体词法分析期间暂存，回放到所属词法单元时再交给错误处理器，
+ *          与语法错误的输出顺序保持一致
+ */
+void Lexer::Report(const unsigned int n, const wstring& extra)
+{
+    if (deferring) {
+        diags.push_back(LexDiag{ tokens.size(), n, extra, preWordRow, preWordCol, rowPos, colPos });
+        return;
+    }
+    errors->error(n, extra.c_str(), preWordRow, preWordCol, rowPos, colPos);
+}
+
+/**
+ * @brief 把当前词法单元追加到词法单元序列
+ */
+void Lexer::PushToken()
+{
+    Token token;
+    token.type = static_cast<uint32_t>(tokenType);
+    token.offset = static_cast<uint32_t>(tokenStart);
+    token.length = static_cast<uint32_t>(tokenPending ? tokenLength : strToken.length());
+    token.row = static_cast<uint32_t>(rowPos);
+    token.col = static_cast<uint32_t>(colPos);
+    token.preRow = static_cast<uint32_t>(preWordRow);
+    token.preCol = static_cast<uint32_t>(preWordCol);
+    token.atom = tokenAtom;
+    token.ch = ch;
+    tokens.push_back(token);
+}
+
+/**
+ * @brief 扫描到源程序结束
+ * @details 逐个识别词法单元并追加到序列，最后一个词法单元的当前字符为'\0'
+ */
+void Lexer::ScanTokens()
+{
+    do {
+        GetWord();
+        PushToken();
+    } while (ch != L'\0');
+}
+
+/**
+ * @brief 整体词法分析
+ * @param threads 线程数，1为单线程扫描，0表示按CPU核数
+ * @details 一次扫描整个源程序，得到连续的词法单元序列，随后GetWord按序回放，
+ *          回放时不再扫描字符也不分配内存；词法单元只记录位置，
+ *          要求源程序全部保留(ReadUnicode默认行为)。
+ *          源程序可直接访问且足够大时按行切分多线程扫描，结果与单线程完全一致
+ */
+void Lexer::Tokenize(unsigned threads)
+{
+    tokens.clear();
+    diags.clear();
+
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    const unsigned char* data = reader->GetDirectData();
+    const size_t length = data ? reader->GetDirectLength() : 0;
+    threads = static_cast<unsigned>(min<size_t>(threads, length / PARALLEL_MIN_CHUNK));
+
+    if (threads > 1) {
+        TokenizeParallel(threads);
+    }
+    else {
+        // 按源程序长度预估词法单元数，避免扩容时整体复制
+        deferring = true;
+        tokens.reserve(length / 3);
+        ScanTokens();
+        deferring = false;
+        tokensEnd = nowPtr;
+    }
+
+    // 回到开头，从第一个词法单元开始回放
+    ResetScan();
+    tokenCursor = 0;
+    diagCursor = 0;
+    replaying = true;
+}
+
+/**
+ * @brief 扫描一个按行切分的源程序块
+ * @param begin 块起始位置(行首)
+ * @param end 块结束位置，扫描到此处得到一个'\0'词法单元
+ * @param table 本块私有的原子表
+ * @details 行号从1开始计；除第一块外，上一合法词法单元的行号置为0，
+ *          表示该值继承自前一块，拼接时再补上
+ */
+void Lexer::ScanChunk(size_t begin, size_t end, AtomTable* table)
+{
+    ResetScan();
+    atoms = table;
+    chunkEnd = end;
+    nowPtr = begin;
+    lineStarts.assign(1, begin);
+    if (begin > 0) {
+        ch = L'\n';
+        preWordRow = 0;
+    }
+
+    tokens.clear();
+    diags.clear();
+    replaying = false;
+    deferring = true;
+    tokens.reserve((end - begin) / 3);
+    ScanTokens();
+    deferring = false;
+    tokensEnd = nowPtr;
+}
+
+/**
+ * @brief 多线程分块词法分析
+ * @param threads 块数(线程数)
+ * @details PL/0没有字符串与注释，词法单元不跨行，因此在换行符之后切分，
+ *          各块由独立的词法分析器并行扫描；唯一的例外是':'后紧跟换行时
+ *          换行由':'的错误处理读入，这样的位置不作切分点。
+ *          拼接时按前一块结束处的行号平移行号，补上继承的上一词法单元位置，
+ *          并按出现顺序把各块私有原子映射到全局原子表，原子编号与单线程一致
+ */
+void Lexer::TokenizeParallel(unsigned threads)
+{
+    const unsigned char* data = reader->GetDirectData();
+    const size_t length = reader->GetDirectLength();
+
+    // 在均分点之后的第一个可切分换行处切分
+    vector<size_t> bounds(1, 0);
+    for (unsigned i = 1; i < threads; i++) {
+        size_t pos = max(length / threads * i, bounds.back());
+        while (pos < length) {
+            const void* found = memchr(data + pos, '\n', length - pos);
+            if (!found) {
+                pos = length;
+                break;
+            }
+            pos = static_cast<const unsigned char*>(found) - data + 1;
+            if (pos < 2 || data[pos - 2] != ':') {
+                break;
+            }
+        }
+        if (pos >= length) {
+            break;
+        }
+        bounds.push_back(pos);
+    }
+    bounds.push_back(length);
+    const size_t chunkCnt = bounds.size() - 1;
+
+    // 并行扫描，第一块在当前线程扫描
+    vector<Lexer> parts(chunkCnt);
+    vector<AtomTable> tables(chunkCnt);
+    vector<thread> workers;
+    for (Lexer& part : parts) {
+        part.scanMode = scanMode;
+        part.reader = reader;
+        part.errors = errors;
+    }
+    for (size_t k = 1; k < chunkCnt; k++) {
+        workers.emplace_back(&Lexer::ScanChunk, &parts[k], bounds[k], bounds[k + 1], &tables[k]);
+    }
+    parts[0].ScanChunk(bounds[0], bounds[1], &tables[0]);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    // 按块顺序计算行号偏移、继承位置与原子映射；
+    // 块内出现源程序中的'\0'时该块即为最后一块
+    vector<size_t> rowBase(chunkCnt, 0), first(chunkCnt, 0), kept(chunkCnt, 0);
+    vector<uint32_t> inheritRow(chunkCnt, 0), inheritCol(chunkCnt, 0);
+    vector<vector<Atom>> remap(chunkCnt);
+    size_t used = chunkCnt;
+    size_t total = 0;
+    lineStarts.clear();
+    for (size_t k = 0; k < chunkCnt; k++) {
+        Lexer& part = parts[k];
+        const Token& tail = part.tokens.back();
+        bool last = (k + 1 == chunkCnt) || tail.offset < bounds[k + 1];
+
+        first[k] = total;
+        kept[k] = last ? part.tokens.size() : part.tokens.size() - 1;
+        total += kept[k];
+        lineStarts.insert(lineStarts.end(), part.lineStarts.begin() + (k > 0 ? 1 : 0), part.lineStarts.end());
+        remap[k].resize(tables[k].Size());
+        for (Atom atom = 0; atom < remap[k].size(); atom++) {
+            remap[k][atom] = atoms->Intern(tables[k].Name(atom));
+        }
+        for (const LexDiag& diag : part.diags) {
+            LexDiag merged = diag;
+            merged.token += first[k];
+            merged.row += rowBase[k];
+            if (diag.preRow == 0) {
+                merged.preRow = inheritRow[k];
+                merged.preCol += inheritCol[k];
+            }
+            else {
+                merged.preRow += rowBase[k];
+            }
+            diags.push_back(merged);
+        }
+
+        if (last) {
+            tokensEnd = part.tokensEnd;
+            used = k + 1;
+            break;
+        }
+
+        // 块结束处的'\0'词法单元给出下一块起始的行号与继承位置
+        rowBase[k + 1] = rowBase[k] + tail.row - 1;
+        inheritRow[k + 1] = tail.preRow == 0 ? inheritRow[k] : static_cast<uint32_t>(tail.preRow + rowBase[k]);
+        inheritCol[k + 1] = tail.preRow == 0 ? tail.preCol + inheritCol[k] : tail.preCol;
+    }
+
+    // 并行平移各块的词法单元并写入最终序列
+    tokens.resize(total);
+    auto stitch = [&](size_t k) {
+        const vector<Token>& src = parts[k].tokens;
+        Token* dst = tokens.data() + first[k];
+        const uint32_t base = static_cast<uint32_t>(rowBase[k]);
+        for (size_t i = 0; i < kept[k]; i++) {
+            Token token = src[i];
+            token.row += base;
+            if (token.preRow == 0) {
+                token.preRow = inheritRow[k];
+                token.preCol += inheritCol[k];
+            }
+            else {
+                token.preRow += base;
+            }
+            if (token.atom != NO_ATOM) {
+                token.atom = remap[k][token.atom];
+            }
+            dst[i] = token;
+        }
+    };
+    workers.clear();
+    for (size_t k = 1; k < used; k++) {
+        workers.emplace_back(stitch, k);
+    }
+    stitch(0);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief 回放下一个词法单元
+ * @return 成功回放返回true；序列已结束返回false，此后GetWord从结束位置继续扫描
+ */
+bool Lexer::ReplayNext()
+{
+    if (tokenCursor >= tokens.size()) {
+        replaying = false;
+        return false;
+    }
+
+    // 先报告属于该词法单元的词法错误
+    while (diagCursor < diags.size() && diags[diagCursor].token == tokenCursor) {
+        const LexDiag& diag = diags[diagCursor++];
+        errors->error(diag.n, diag.extra.c_str(), diag.preRow, diag.preCol, diag.row, diag.col);
+    }
+
+    const Token& token = tokens[tokenCursor++];
+    LoadToken(token, (tokenCursor == tokens.size()) ? tokensEnd : token.offset + token.length);
+    return true;
+}
+
+/**
+ * @brief 按词法单元记录还原扫描状态
+ * @param token 词法单元记录
+ * @param end 该词法单元之后的读取位置
+ */
+void Lexer::LoadToken(const Token& token, size_t end)
+{
+    tokenType = token.type;
+    tokenStart = token.offset;
+    tokenLength = token.length;
+    tokenPending = true;
+    tokenAtom = token.atom;
+    strToken.clear();
+    nowPtr = end;
+    rowPos = token.row;
+    colPos = token.col;
+    preWordRow = token.preRow;
+    preWordCol = token.preCol;
+    ch = token.ch;
+}
+
+/* ============================================================
+ *                 流水线模式 (词法分析线程)
+ * ============================================================ */
+
+/**
+ * @brief 启动词法分析线程
+ * @return 成功启动返回true；源程序不可直接访问时返回false，仍边扫描边分析
+ * @details 词法分析线程与语法分析线程只共享只读的映射内存与环形队列，
+ *          分块存储按需加载、不可并发访问，因此要求源程序可直接访问
+ */
+bool Lexer::StartPipeline()
+{
+    StopPipeline();
+    if (!reader->GetDirectData()) {
+        return false;
+    }
+    pipeline = new TokenPipeline;
+    pipeline->scanner.scanMode = scanMode;
+    pipeline->scanner.reader = reader;
+    pipeline->scanner.errors = errors;
+    pipeline->producer = thread(&Lexer::Produce, &pipeline->scanner, pipeline);
+    return true;
+}
+
+/**
+ * @brief 停止词法分析线程
+ * @details 语法分析提前结束时词法分析线程可能正等待空槽，先通知其退出再等待
+ */
+void Lexer::StopPipeline()
+{
+    if (!pipeline) {
+        return;
+    }
+    pipeline->stop.store(true, memory_order_relaxed);
+    pipeline->producer.join();
+    delete pipeline;
+    pipeline = nullptr;
+}
+
+/**
+ * @brief 词法分析线程: 分批扫描并送入环形队列
+ * @param pipe 共享状态
+ * @details 在本词法分析器上从头扫描，每PIPELINE_BATCH个词法单元为一批；
+ *          词法错误照常暂存，批内的词法单元、错误与行首记录整体交换进队列槽，
+ *          槽中旧的容器换回后复用
+ */
+void Lexer::Produce(TokenPipeline* pipe)
+{
+    ResetScan();
+    atoms = &pipe->table;
+    lineStarts.assign(1, 0);
+    replaying = false;
+    deferring = true;
+
+    Atom shipped = 0;
+    bool done = false;
+    while (!done) {
+        tokens.clear();
+        diags.clear();
+        do {
+            GetWord();
+            PushToken();
+        } while (ch != L'\0' && tokens.size() < PIPELINE_BATCH);
+        done = (ch == L'\0');
+
+        TokenBatch* slot;
+        while (!(slot = pipe->ring.BeginPush())) {
+            if (pipe->stop.load(memory_order_relaxed)) {
+                return;
+            }
+            this_thread::yield();
+        }
+        swap(slot->tokens, tokens);
+        swap(slot->diags, diags);
+
+        // 行首: 保留最后一个供RecordLine比较，其余交给消费端
+        slot->lines.assign(lineStarts.begin() + 1, lineStarts.end());
+        lineStarts.erase(lineStarts.begin(), lineStarts.end() - 1);
+
+        // 本批首次出现的标识符名称
+        slot->firstAtom = shipped;
+        slot->names.clear();
+        slot->nameEnds.clear();
+        for (; shipped < atoms->Size(); shipped++) {
+            slot->names += atoms->NameUtf8(shipped);
+            slot->nameEnds.push_back(static_cast<uint32_t>(slot->names.size()));
+        }
+
+        slot->end = nowPtr;
+        slot->last = done;
+        pipe->ring.EndPush();
+    }
+}
+
+/**
+ * @brief 流水线模式: 取下一个词法单元
+ * @return 成功取得返回true；最后一批已取完返回false，此后GetWord从结束位置继续扫描
+ * @details 与回放相同，先报告属于该词法单元的词法错误，输出顺序与边扫描边分析一致；
+ *          标识符首次出现时才登记到全局原子表，原子编号也与单线程一致
+ */
+bool Lexer::PullNext()
+{
+    TokenPipeline* pipe = pipeline;
+    if (pipe->current && pipe->cursor == pipe->current->tokens.size()) {
+        bool last = pipe->current->last;
+        pipe->ring.Pop();
+        pipe->current = nullptr;
+        if (last) {
+            StopPipeline();
+            return false;
+        }
+    }
+    if (!pipe->current) {
+        while (!(pipe->current = pipe->ring.Front())) {
+            this_thread::yield();
+        }
+        pipe->cursor = 0;
+        pipe->diagCursor = 0;
+        lineStarts.insert(lineStarts.end(), pipe->current->lines.begin(), pipe->current->lines.end());
+    }
+
+    TokenBatch& batch = *pipe->current;
+    while (pipe->diagCursor < batch.diags.size() && batch.diags[pipe->diagCursor].token == pipe->cursor) {
+        const LexDiag& diag = batch.diags[pipe->diagCursor++];
+        errors->error(diag.n, diag.extra.c_str(), diag.preRow, diag.preCol, diag.row, diag.col);
+    }
+
+    const Token& token = batch.tokens[pipe->cursor++];
+    bool lastToken = batch.last && pipe->cursor == batch.tokens.size();
+    LoadToken(token, lastToken ? batch.end : token.offset + token.length);
+    if (token.atom != NO_ATOM) {
+        if (token.atom == pipe->remap.size()) {
+            size_t k = token.atom - batch.firstAtom;
+            size_t begin = k > 0 ? batch.nameEnds[k - 1] : 0;
+            pipe->remap.push_back(atoms->InternUtf8(batch.names.data() + begin, batch.nameEnds[k] - begin));
+        }
+        tokenAtom = pipe->remap[token.atom];
+    }
+    return true;
+}
+
+/**
+ * @brief 获取当前词法单元的原子
+ * @return 标识符在识别时已分配原子；其他词法单元按其字符串在首次调用时分配
+ */
+Atom Lexer::GetAtom()
+{
+    if (tokenAtom == NO_ATOM) {
+        tokenAtom = atoms->Intern(GetStrToken());
+    }
+    return tokenAtom;
+}
+
+/**
+ * @brief 复制为wstring
+ */
+wstring SourceSpan::str() const
+{
+    wstring text(length, L'\0');
+    for (size_t i = 0; i < length; i++) {
+        text[i] = (*this)[i];
+    }
+    return text;
+}
+
+/**
+ * @brief 与字符串比较
+ */
+bool SourceSpan::operator==(const wstring& other) const
+{
+    if (other.length() != length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if ((*this)[i] != other[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 查找保留字
+ * @return 保留字对应的词法单元类型，不是保留字返回IDENT
+ */
+unsigned long Lexer::Reserve()
+{
+    return LookupKeyword(strToken.data(), strToken.length());
+}
+
+/**
+ * @struct DirectSource
+ * @brief 直接访问映射内存的字符源
+ */
+struct DirectSource
+{
+    const unsigned char* data;
+    size_t length;
+    wchar_t end;              // 结束处的字符: 文件末尾为'#'，分块结束为'\0'
+
+    wchar_t operator()(size_t pos) const
+    {
+        if (pos < length) return data[pos];
+        return pos == length ? end : L'\0';
+    }
+
+    // pos处的完整字符(多字节UTF-8字符解码)
+    wchar_t Char(size_t pos) const
+    {
+        wchar_t c = (*this)(pos);
+        if (c >= 0x80) {
+            size_t bytes;
+            c = DecodeUtf8(data + pos, bytes);
+        }
+        return c;
+    }
+
+    // 从pos开始连续等于c的字符数(c为ASCII)
+    size_t Run(size_t pos, wchar_t c) const
+    {
+        if (pos >= length) return 0;
+        return ScanRun(data + pos, length - pos, static_cast<unsigned char>(c));
+    }
+};
+
+/**
+ * @struct StoreSource
+ * @brief 经由分块存储访问的字符源
+ */
+struct StoreSource
+{
+    ReadUnicode* reader;    // 源文件读取器
+
+    wchar_t operator()(size_t pos) const
+    {
+        return reader->getProgmWStr(pos);
+    }
+
+    // pos处的完整字符
+    wchar_t Char(size_t pos) const
+    {
+        return reader->getProgmWStr(pos);
+    }
+
+    // 从pos开始连续等于c的字符数
+    size_t Run(size_t pos, wchar_t c) const
+    {
+        size_t n = 0;
+        while (reader->getProgmWStr(pos + n) == c) {
+            n++;
+        }
+        return n;
+    }
+};
+
+/**
+ * @brief 表驱动扫描下一个词法单元
+ * @return 成功识别返回true；遇到错误状态返回false，此时已跳过空白与换行，
+ *         nowPtr指向词法单元首字符，由逐字符扫描继续处理并报告错误
+ * @details 位置、行列号以及结束后的当前字符与逐字符扫描完全一致
+ */
+bool Lexer::ScanDFA()
+{
+    const unsigned char* data = reader->GetDirectData();
+    if (data) {
+        size_t length = reader->GetDirectLength();
+        if (chunkEnd < length) {
+            return ScanTable(DirectSource{ data, chunkEnd, L'\0' });
+        }
+        return ScanTable(DirectSource{ data, length, L'#' });
+    }
+    return ScanTable(StoreSource{ reader });
+}
+
+/**
+ * @brief 按给定的字符访问方式执行表驱动扫描
+ * @param source 字符源，按位置返回字符
+ */
+template <typename Source>
+bool Lexer::ScanTable(const Source& source)
+{
+    // 跳过空白与换行: 连续的空行与空格整段跳过，不逐字符查表
+    wchar_t c = source(nowPtr);
+    unsigned char cls = ClassOf(c);
+    while (cls == CC_SPACE || cls == CC_NEWLINE) {
+        ch = c;
+        if (c == L'\n') {
+            size_t run = source.Run(nowPtr, c);
+            for (size_t i = 0; i < run; i++) {
+                nowPtr++;
+                RecordLine();
+            }
+            colPos = 0;
+            rowPos += run;
+        }
+        else if (c == L' ') {
+            size_t run = source.Run(nowPtr, c);
+            nowPtr += run;
+            colPos += run;
+        }
+        else {
+            nowPtr++;
+            colPos++;
+        }
+        c = source(nowPtr);
+        cls = ClassOf(c);
+    }
+
+    // 文件结束与结束符
+    if (cls == CC_END || cls == CC_HASH) {
+        ch = c;
+        tokenStart = nowPtr;
+        nowPtr++;
+        colPos++;
+        if (cls == CC_HASH) {
+            tokenLength = 1;
+            tokenPending = true;
+            tokenType = NUL;
+        }
+        return true;
+    }
+
+    // 按转移表推进，直到终止动作
+    size_t start = nowPtr;
+    size_t pos = nowPtr;
+    unsigned char state = DS_START;
+    unsigned char prev = DS_START;
+    while (state < DS_COUNT) {
+        prev = state;
+        state = dfa.next[state][cls];
+        if (state < DS_COUNT) {
+            // 停留在同一状态时(标识符、数字)连续推进
+            do {
+                c = source(++pos);
+                cls = ClassOf(c);
+            } while (dfa.next[state][cls] == state);
+        }
+    }
+    if (state == DS_ERROR) {
+        return false;
+    }
+
+    size_t end = (state == DS_ACCEPT) ? pos + 1 : pos;
+    // 只记录位置，strToken在GetStrToken时生成
+    tokenStart = start;
+    tokenLength = end - start;
+    tokenPending = true;
+
+    tokenType = dfa.type[prev][cls];
+    if (prev == DS_IDENT) {
+        tokenType = MatchKeyword(source, start, tokenLength);
+        if (tokenType == IDENT) {
+            tokenAtom = atoms->InternFrom(source, start, tokenLength);
+        }
+    }
+    else if (tokenType == GEQ) {
+        preWordCol++;
+    }
+
+    ch = c < 0x80 ? c : source.Char(end);
+    colPos += end - start;
+    nowPtr = end;
+    return true;
 }
 
 /**
  * @brief 获取下一个词法单元
- * @details 主扫描函数，识别并返回下一个词法单元的类型和值
+ * @details 主扫描函数，识别并返回下一个词法单元的类型和值；
+ *          DFA模式下先由ScanDFA扫描，出错时回到逐字符扫描报告错误
  */
 void Lexer::GetWord()
 {
+    // 流水线模式下从队列取，整体词法分析后按序回放
+    if (pipeline && PullNext()) {
+        return;
+    }
+    if (replaying && ReplayNext()) {
+        return;
+    }
+
     // 更新上一个合法词法单元的位置
     if (ch != L'\n') {
         preWordCol = colPos;
@@ -173,23 +1148,31 @@ void Lexer::GetWord()
     }
 
     strToken.clear();
+    tokenPending = false;
+    tokenAtom = NO_ATOM;
+    if (scanMode == SCAN_DFA && ScanDFA()) {
+        return;
+    }
     GetBC();
     GetChar();
 
+    // 换行处理: 循环跳过连续空行，不递归，栈深度与空行数无关
+    while (ch == L'\n') {
+        colPos = 0;
+        rowPos++;
+        RecordLine();
+        GetBC();
+        GetChar();
+    }
+    tokenStart = chStart;
+
     // 文件结束
     if (ch == L'\0') {
         return;
     }
     
-    // 换行处理
-    if (ch == L'\n') {
-        colPos = 0;
-        rowPos++;
-        GetWord();  // 递归获取下一个词法单元
-        return;
-    }
     // 结束符
-    else if (ch == L'#') {
+    if (ch == L'#') {
         Concat();
         tokenType = NUL;
     }
@@ -202,26 +1185,10 @@ void Lexer::GetWord()
             GetChar();
         }
 
-        // 查找保留字表
-        int code = Reserve();
-        switch (code) {
-        case -1:  tokenType = IDENT;      break;
-        case 0:   tokenType = ODD_SYM;    break;
-        case 1:   tokenType = BEGIN_SYM;  break;
-        case 2:   tokenType = END_SYM;    break;
-        case 3:   tokenType = IF_SYM;     break;
-        case 4:   tokenType = THEN_SYM;   break;
-        case 5:   tokenType = WHILE_SYM;  break;
-        case 6:   tokenType = DO_SYM;     break;
-        case 7:   tokenType = CALL_SYM;   break;
-        case 8:   tokenType = CONST_SYM;  break;
-        case 9:   tokenType = VAR_SYM;    break;
-        case 10:  tokenType = PROC_SYM;   break;
-        case 11:  tokenType = WRITE_SYM;  break;
-        case 12:  tokenType = READ_SYM;   break;
-        case 13:  tokenType = PROGM_SYM;  break;
-        case 14:  tokenType = ELSE_SYM;   break;
-        default:  tokenType = NUL;        break;
+        // 查找保留字表，标识符分配原子
+        tokenType = Reserve();
+        if (tokenType == IDENT) {
+            tokenAtom = atoms->Intern(strToken);
         }
         Retract();
     }
@@ -235,8 +1202,7 @@ void Lexer::GetWord()
         }
         // 数字后面紧跟字母是非法的
         if (IsLetter()) {
-            errorHandle.error(ILLEGAL_WORD, (L"'" + strToken + L"'").c_str(),
-                              preWordRow, preWordCol, rowPos, colPos);
+            Report(ILLEGAL_WORD, L"'" + strToken + L"'");
             // 跳过直到下一个界符
             while (!IsBoundary()) {
                 GetChar();
@@ -259,7 +1225,11 @@ void Lexer::GetWord()
             tokenType = ASSIGN;
         }
         else {
-            errorHandle.error(MISSING, L"'='", preWordRow, preWordCol, rowPos, colPos);
+            Report(MISSING, L"'='");
+            // 换行符已被读入，行号不变但仍需索引该行
+            if (ch == L'\n') {
+                RecordLine();
+            }
             strToken.clear();
             tokenType = NUL;
         }
@@ -315,8 +1285,7 @@ void Lexer::GetWord()
         }
         else {
             Concat();
-            errorHandle.error(ILLEGAL_WORD, (L"'" + strToken + L"'").c_str(),
-                              preWordRow, preWordCol, rowPos, colPos);
+            Report(ILLEGAL_WORD, L"'" + strToken + L"'");
             tokenType = NUL;
         }
     }
@@ -330,6 +1299,3 @@ wchar_t Lexer::GetCh()
 {
     return ch;
 }
-
-// 词法分析器全局实例
-Lexer lexer;
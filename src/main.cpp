@@ -6,31 +6,15 @@
  */
 
 #include <Types.hpp>
-#include <Lexer.hpp>
-#include <ErrorHandle.hpp>
-#include <SymTable.hpp>
-#include <Parser.hpp>
-#include <Interpreter.hpp>
+#include <Compiler.hpp>
+#include <Benchmark.hpp>
+#include <Batch.hpp>
+#include <Driver.hpp>
 using namespace std;
 
 // 测试文件目录
 const string TEST_DIR = "test/";
 
-/**
- * @brief 初始化编译器各模块
- * @details 重置词法分析器、错误处理器、符号表和P-Code列表
- */
-void init()
-{
-    readUnicode.InitReadUnicode();
-    lexer.InitLexer();
-    errorHandle.InitErrorHandle();
-    // 设置控制台为Unicode输出模式
-    _setmode(_fileno(stdout), _O_U16TEXT);
-    symTable.InitAndClear();
-    pcodelist.clear();
-}
-
 /**
  * @brief 获取测试文件的完整路径
  * @param filename 文件名
@@ -41,11 +25,25 @@ string getFilePath(const string& filename)
     return TEST_DIR + filename;
 }
 
+/**
+ * @brief 初始化编译上下文并打开测试文件
+ * @param context 编译上下文
+ * @param filename 测试文件名
+ * @return 文件打开成功返回true
+ */
+bool OpenTestFile(CompilerContext& context, const string& filename)
+{
+    // 设置控制台为Unicode输出模式
+    _setmode(_fileno(stdout), _O_U16TEXT);
+    return context.Open(getFilePath(filename));
+}
+
 /**
  * @brief 词法分析测试
  * @details 读取源文件并执行词法分析，输出识别的词法单元
+ * @param context 编译上下文
  */
-void TestLexer()
+void TestLexer(CompilerContext& context)
 {
     string filename = "";
     wcout << L"=== 词法分析测试 ===" << endl;
@@ -53,18 +51,16 @@ void TestLexer()
     
     while (cin >> filename)
     {
-        init();
-        readUnicode.readFile2USC2(getFilePath(filename));
-        if (readUnicode.isEmpty())
+        if (!OpenTestFile(context, filename))
         {
             wcout << L"文件打开失败，请重新输入文件名: ";
             continue;
         }
 
-        lexer.GetWord();
-        while (lexer.GetCh() != L'\0')
+        context.lexer.GetWord();
+        while (context.lexer.GetCh() != L'\0')
         {
-            lexer.GetWord();
+            context.lexer.GetWord();
         }
         wcout << L"词法分析完成!" << endl;
         return;
@@ -74,8 +70,9 @@ void TestLexer()
 /**
  * @brief 语法分析测试
  * @details 读取源文件并执行语法分析，检查语法错误
+ * @param context 编译上下文
  */
-void TestParser()
+void TestParser(CompilerContext& context)
 {
     string filename = "";
     wcout << L"=== 语法分析测试 ===" << endl;
@@ -83,15 +80,13 @@ void TestParser()
     
     while (cin >> filename)
     {
-        init();
-        readUnicode.readFile2USC2(getFilePath(filename));
-        if (readUnicode.isEmpty())
+        if (!OpenTestFile(context, filename))
         {
             wcout << L"文件打开失败，请重新输入文件名: ";
             continue;
         }
 
-        parser.analyze();
+        context.Compile();
         break;
     }
 }
@@ -99,8 +94,9 @@ void TestParser()
 /**
  * @brief 符号表测试
  * @details 读取源文件，执行语法分析后输出符号表内容
+ * @param context 编译上下文
  */
-void TestSymTable()
+void TestSymTable(CompilerContext& context)
 {
     string filename = "";
     wcout << L"=== 符号表测试 ===" << endl;
@@ -108,16 +104,17 @@ void TestSymTable()
     
     while (cin >> filename)
     {
-        init();
-        readUnicode.readFile2USC2(getFilePath(filename));
-        if (readUnicode.isEmpty())
+        if (!OpenTestFile(context, filename))
         {
             wcout << L"文件打开失败，请重新输入文件名: ";
             continue;
         }
 
-        parser.analyze();
-        symTable.showAll();
+        context.Compile();
+        context.symTable.showAll();
+        wcout << L"[Info] Symbol table: " << context.symTable.table.size() << L" entries, "
+              << context.symTable.GetInfoBytes() << L" bytes of records, "
+              << context.symTable.GetMemoryBytes() / 1024 << L" KB heap" << endl;
         return;
     }
 }
@@ -125,8 +122,9 @@ void TestSymTable()
 /**
  * @brief P-Code生成测试
  * @details 读取源文件，执行编译并输出生成的P-Code指令
+ * @param context 编译上下文
  */
-void TestPCode()
+void TestPCode(CompilerContext& context)
 {
     string filename = "";
     wcout << L"=== P-Code生成测试 ===" << endl;
@@ -134,17 +132,15 @@ void TestPCode()
     
     while (cin >> filename)
     {
-        init();
-        readUnicode.readFile2USC2(getFilePath(filename));
-        if (readUnicode.isEmpty())
+        if (!OpenTestFile(context, filename))
         {
             wcout << L"文件打开失败，请重新输入文件名: ";
             continue;
         }
 
-        parser.analyze();
+        context.Compile();
         wcout << L"\n=== 生成的P-Code ===" << endl;
-        pcodelist.show();
+        context.pcodelist.show();
         return;
     }
 }
@@ -152,8 +148,9 @@ void TestPCode()
 /**
  * @brief 完整编译运行测试
  * @details 读取源文件，执行完整编译流程，若无错误则运行程序
+ * @param context 编译上下文
  */
-void Test()
+void Test(CompilerContext& context)
 {
     string filename = "";
     wcout << L"=== 完整编译测试 ===" << endl;
@@ -161,23 +158,21 @@ void Test()
     
     while (cin >> filename)
     {
-        init();
-        readUnicode.readFile2USC2(getFilePath(filename));
-        if (readUnicode.isEmpty())
+        if (!OpenTestFile(context, filename))
         {
             wcout << L"文件打开失败，请重新输入文件名: ";
             continue;
         }
 
-        parser.analyze();
+        bool succeeded = context.Compile();
         wcout << L"\n=== 生成的P-Code ===" << endl;
-        pcodelist.show();
+        context.pcodelist.show();
         
         // 只有在没有错误时才执行程序
-        if (errorHandle.GetError() == 0)
+        if (succeeded)
         {
             wcout << L"\n=== 程序运行结果 ===" << endl;
-            interpreter.run();
+            context.Run();
         }
         return;
     }
@@ -194,6 +189,8 @@ void showMenu()
     wcout << L"3. 符号表测试" << endl;
     wcout << L"4. P-Code生成测试" << endl;
     wcout << L"5. 完整编译运行" << endl;
+    wcout << L"6. 性能测试" << endl;
+    wcout << L"7. 批量编译" << endl;
     wcout << L"0. 退出" << endl;
     wcout << L"==================================" << endl;
     wcout << L"请选择功能: ";
@@ -201,13 +198,20 @@ void showMenu()
 
 /**
  * @brief 程序主入口
+ * @param argc 参数个数
+ * @param argv 参数列表，带参数时按命令行驱动执行，否则进入交互菜单
  * @return 程序退出码
  */
-int main()
+int main(int argc, char* argv[])
 {
     // 设置控制台为Unicode输出模式
     _setmode(_fileno(stdout), _O_U16TEXT);
-    
+
+    if (argc > 1) {
+        return RunCommandLine(argc, argv);
+    }
+
+    CompilerContext context;
     int choice = -1;
     while (choice != 0)
     {
@@ -217,19 +221,25 @@ int main()
         switch (choice)
         {
         case 1:
-            TestLexer();
+            TestLexer(context);
             break;
         case 2:
-            TestParser();
+            TestParser(context);
             break;
         case 3:
-            TestSymTable();
+            TestSymTable(context);
             break;
         case 4:
-            TestPCode();
+            TestPCode(context);
             break;
         case 5:
-            Test();
+            Test(context);
+            break;
+        case 6:
+            RunBenchmark();
+            break;
+        case 7:
+            RunBatch();
             break;
         case 0:
             wcout << L"程序退出" << endl;
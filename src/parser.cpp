@@ -7,9 +7,6 @@
 
 #include <parser.hpp>
 
-// 语法分析器全局实例
-Parser parser;
-
 /**
  * @brief 报告语法错误
  * @param errorType 错误类型
@@ -96,6 +93,366 @@ int Parser::judge(const unsigned long s1, const unsigned long s2, const unsigned
         return 1;
 }
 
+/* ============================================================
+ *                 代码生成 (直接生成 / 建立语法树)
+ * ============================================================ */
+
+/**
+ * @brief 分配语法树节点
+ */
+AstNode* Parser::NewNode(AstKind kind, int L, int a)
+{
+    AstNode* node = astArena.New<AstNode>();
+    node->kind = kind;
+    node->L = L;
+    node->a = a;
+    return node;
+}
+
+/**
+ * @brief 常量
+ */
+AstNode* Parser::GenLit(int L, int a)
+{
+    if (!buildAst) {
+        pcodelist.emit(lit, L, a);
+        return nullptr;
+    }
+    return NewNode(AST_LIT, L, a);
+}
+
+/**
+ * @brief 取变量
+ */
+AstNode* Parser::GenLoad(int L, int a)
+{
+    if (!buildAst) {
+        pcodelist.emit(load, L, a);
+        return nullptr;
+    }
+    return NewNode(AST_LOAD, L, a);
+}
+
+/**
+ * @brief 操作数是否为刚生成的常量
+ * @param depth 直接模式下操作数末条指令距序列末尾的距离
+ * @details 后缀代码中以LIT结尾的表达式只能是单个常量，
+ *          因此直接模式只需检查对应位置的指令；有错误时不折叠
+ */
+bool Parser::ConstOperand(AstNode* node, size_t depth, int& value)
+{
+    if (!foldConstants || errorHandle.GetErrorCount() != 0)
+        return false;
+    if (buildAst) {
+        if (!node || node->kind != AST_LIT)
+            return false;
+        value = node->a;
+        return true;
+    }
+    const vector<PCode>& code = pcodelist.code_list;
+    if (code.size() <= depth || code[code.size() - 1 - depth].op != lit)
+        return false;
+    value = code[code.size() - 1 - depth].a;
+    return true;
+}
+
+/**
+ * @brief 条件为常量时取出其值并撤销其代码
+ * @param start 直接模式下条件代码的起始地址
+ */
+bool Parser::FoldCondition(AstNode* cond, size_t start, int& value)
+{
+    if (!ConstOperand(cond, 0, value))
+        return false;
+    if (!buildAst) {
+        if (pcodelist.code_list.size() != start + 1)
+            return false;
+        pcodelist.code_list.pop_back();
+    }
+    return true;
+}
+
+/**
+ * @brief 丢弃死分支生成的代码
+ * @param mark 直接模式下死分支代码的起始地址
+ * @return 空节点
+ * @details 语法树模式下死分支的节点不再被引用，随线性分配区整体释放
+ */
+AstNode* Parser::DropCode(size_t mark)
+{
+    if (!buildAst)
+        pcodelist.code_list.erase(pcodelist.code_list.begin() + mark, pcodelist.code_list.end());
+    return nullptr;
+}
+
+/**
+ * @brief 一元运算
+ * @details 直接模式下操作数已生成，只需生成运算指令；
+ *          操作数为常量时原地改为运算结果
+ */
+AstNode* Parser::GenUnary(int op, AstNode* operand)
+{
+    int value;
+    if (ConstOperand(operand, 0, value) && FoldOperation(op, value, 0, value)) {
+        if (!buildAst) {
+            pcodelist.code_list.back().a = value;
+            return nullptr;
+        }
+        operand->a = value;
+        return operand;
+    }
+    if (!buildAst) {
+        pcodelist.emit(opr, 0, op);
+        return nullptr;
+    }
+    AstNode* node = NewNode(AST_UNARY);
+    node->op = op;
+    node->left = operand;
+    return node;
+}
+
+/**
+ * @brief 二元运算
+ * @param op 运算类型，OPR_NONE表示只求值两侧
+ * @details 两侧均为常量且运算不会在运行时出错时合并为一个常量
+ */
+AstNode* Parser::GenBinary(int op, AstNode* lhs, AstNode* rhs)
+{
+    int a, b;
+    if (ConstOperand(rhs, 0, b) && ConstOperand(lhs, 1, a) && FoldOperation(op, a, b, a)) {
+        if (!buildAst) {
+            pcodelist.code_list.pop_back();
+            pcodelist.code_list.back().a = a;
+            return nullptr;
+        }
+        lhs->a = a;
+        return lhs;
+    }
+    if (!buildAst) {
+        if (op != OPR_NONE)
+            pcodelist.emit(opr, 0, op);
+        return nullptr;
+    }
+    AstNode* node = NewNode(AST_BINARY);
+    node->op = op;
+    node->left = lhs;
+    node->right = rhs;
+    return node;
+}
+
+/**
+ * @brief 赋值
+ * @param target 目标变量，未声明时为空(只求值不存储)
+ */
+AstNode* Parser::GenAssign(AstNode* value, VarInfo* target)
+{
+    int L = target ? target->level : 0;
+    int a = target ? target->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + target->level + 1 : 0;
+    if (!buildAst) {
+        if (target)
+            pcodelist.emit(store, L, a);
+        return nullptr;
+    }
+    AstNode* node = NewNode(AST_ASSIGN, L, a);
+    node->flags = target ? AST_HAS_TARGET : 0;
+    node->left = value;
+    return node;
+}
+
+/**
+ * @brief 跳转
+ * @return 直接模式返回指令地址，语法树模式返回0(只表示已生成)
+ */
+int Parser::GenJump(Operation op, int a)
+{
+    return buildAst ? 0 : pcodelist.emit(op, 0, a);
+}
+
+/**
+ * @brief 回填跳转到当前位置
+ */
+void Parser::GenPatch(int entry)
+{
+    if (!buildAst)
+        pcodelist.backpatch(entry, pcodelist.code_list.size());
+}
+
+/**
+ * @brief 条件语句
+ * @param hasJpc 是否生成了JPC
+ * @param hasJmp 是否生成了JMP
+ */
+AstNode* Parser::GenIf(AstNode* cond, AstNode* thenPart, AstNode* elsePart, bool hasJpc, bool hasJmp)
+{
+    if (!buildAst)
+        return nullptr;
+    AstNode* node = NewNode(AST_IF);
+    node->flags = (hasJpc ? AST_HAS_JPC : 0) | (hasJmp ? AST_HAS_JMP : 0);
+    node->left = cond;
+    node->right = thenPart;
+    node->other = elsePart;
+    return node;
+}
+
+/**
+ * @brief 循环语句
+ * @param hasBody 是否有循环体(有则生成跳回条件的JMP)
+ */
+AstNode* Parser::GenWhile(AstNode* cond, AstNode* loopBody, bool hasBody)
+{
+    if (!buildAst)
+        return nullptr;
+    AstNode* node = NewNode(AST_WHILE);
+    node->flags = hasBody ? AST_HAS_BODY : 0;
+    node->left = cond;
+    node->right = loopBody;
+    return node;
+}
+
+/**
+ * @brief 传递实参
+ * @param index 实参序号(从0开始)
+ */
+AstNode* Parser::GenArg(AstNode* value, ProcInfo* callee, size_t index)
+{
+    int a = ACT_PRE_REC_SIZE + callee->level + 1 + 1 + index;
+    if (!buildAst) {
+        pcodelist.emit(store, -1, a);
+        return nullptr;
+    }
+    AstNode* node = NewNode(AST_ARG, -1, a);
+    node->left = value;
+    return node;
+}
+
+/**
+ * @brief 调用语句
+ * @param args 实参列表
+ * @param hasCall 是否生成CAL指令
+ * @details 过程入口在降级时读取
+ */
+AstNode* Parser::GenCall(AstNode* args, ProcInfo* callee, bool hasCall)
+{
+    if (!buildAst) {
+        if (hasCall)
+            pcodelist.emit(call, callee->level, callee->entry);
+        return nullptr;
+    }
+    AstNode* node = NewNode(AST_CALL, hasCall ? callee->level : 0);
+    node->flags = hasCall ? AST_HAS_TARGET : 0;
+    node->left = args;
+    node->info = callee;
+    return node;
+}
+
+/**
+ * @brief 读入一个变量
+ */
+AstNode* Parser::GenReadVar(VarInfo* target)
+{
+    int a = target->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + target->level + 1;
+    if (!buildAst) {
+        pcodelist.emit(red, 0, 0);
+        pcodelist.emit(store, target->level, a);
+        return nullptr;
+    }
+    return NewNode(AST_LOAD, target->level, a);
+}
+
+/**
+ * @brief 读语句
+ */
+AstNode* Parser::GenRead(AstNode* targets)
+{
+    if (!buildAst)
+        return nullptr;
+    AstNode* node = NewNode(AST_READ);
+    node->left = targets;
+    return node;
+}
+
+/**
+ * @brief 输出一项
+ */
+AstNode* Parser::GenPrint(AstNode* value)
+{
+    if (!buildAst) {
+        pcodelist.emit(wrt, 0, 0);
+        return nullptr;
+    }
+    AstNode* node = NewNode(AST_PRINT);
+    node->left = value;
+    return node;
+}
+
+/**
+ * @brief 写语句
+ * @details 无论输出项是否完整，结束时都输出换行
+ */
+AstNode* Parser::GenWrite(AstNode* items)
+{
+    if (!buildAst) {
+        pcodelist.emit(opr, 0, 13);
+        return nullptr;
+    }
+    AstNode* node = NewNode(AST_WRITE);
+    node->left = items;
+    return node;
+}
+
+/**
+ * @brief 语句序列
+ */
+AstNode* Parser::GenSeq(AstNode* list)
+{
+    if (!buildAst)
+        return nullptr;
+    AstNode* node = NewNode(AST_SEQ);
+    node->left = list;
+    return node;
+}
+
+/**
+ * @brief 过程(含主程序)开始
+ * @return 语法树模式下追加到当前分程序过程列表的节点，直接模式返回空
+ */
+AstNode* Parser::BeginProc()
+{
+    if (!buildAst)
+        return nullptr;
+    AstNode* node = NewNode(AST_PROC);
+    *procTail = node;
+    procTail = &node->next;
+    return node;
+}
+
+/**
+ * @brief 过程入口JMP
+ * @param info 过程信息，记录JMP地址为入口
+ */
+void Parser::GenProcEntry(AstNode* node, Information* info)
+{
+    if (!buildAst) {
+        size_t entry = pcodelist.emit(jmp, 0, 0);
+        info->SetEntry(entry);
+        return;
+    }
+    node->info = info;
+}
+
+/**
+ * @brief 分程序结束后的返回指令
+ */
+void Parser::GenReturn(AstNode* node, AstNode* blockNode)
+{
+    if (!buildAst) {
+        pcodelist.emit(opr, 0, OPR_RETURN);
+        return;
+    }
+    node->right = blockNode;
+    node->flags |= AST_HAS_RETURN;
+}
+
 /* ============================================================
  * PL/0 文法定义 (供参考)
  * ============================================================
@@ -119,12 +476,13 @@ int Parser::judge(const unsigned long s1, const unsigned long s2, const unsigned
  * @details 处理赋值语句、条件语句、循环语句、调用语句、
  *          复合语句、读写语句等
  */
-void Parser::statement()
+AstNode* Parser::statement()
 {
+    AstNode* node = nullptr;
     // 赋值语句: <id> := <exp>
     if (lexer.GetTokenType() == IDENT)
     {
-        int pos = symTable.SearchInfo(lexer.GetStrToken(), Category::VAR);
+        int pos = symTable.SearchInfo(lexer.GetAtom(), Category::VAR);
         VarInfo *cur_info = nullptr;
         if (pos == -1)
             errorHandle.error(UNDECLARED_IDENT, lexer.GetStrToken().c_str(),
@@ -132,124 +490,168 @@ void Parser::statement()
         else
             cur_info = (VarInfo *)symTable.table[pos].info;
         lexer.GetWord();
+        AstNode* value = nullptr;
         if (lexer.GetTokenType() == ASSIGN)
         {
             if (cur_info && cur_info->cat == Category::CST)
                 errorHandle.error(ILLEGAL_RVALUE_ASSIGN, lexer.GetPreWordRow(),
                                   lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
             lexer.GetWord();
-            exp();
+            value = exp();
         }
         else if (lexer.GetTokenType() & firstExp)
         {
             errorHandle.error(MISSING, L":=", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-            exp();
+            value = exp();
         }
         else if (lexer.GetTokenType() & EQL)
         {
             errorHandle.error(EXPECT_STH_FIND_ANTH, L":=", L"=", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
             lexer.GetWord();
-            exp();
+            value = exp();
         }
         else
             errorHandle.error(ILLEGAL_DEFINE, L"<ident>", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-        if (cur_info)
-            // 生成存储指令
-            pcodelist.emit(store, cur_info->level, cur_info->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + cur_info->level + 1);
+        // 生成存储指令
+        node = GenAssign(value, cur_info);
     }
     // 条件语句: if <lexp> then <statement> [else <statement>]
     else if (lexer.GetTokenType() & IF_SYM)
     {
         lexer.GetWord();
-        lexp();
+        size_t condition = pcodelist.code_list.size();
+        AstNode* cond = lexp();
+        AstNode* thenPart = nullptr;
+        AstNode* elsePart = nullptr;
         int entry_jpc = -1, entry_jmp = -1;
+        int value;
         
-        if (lexer.GetTokenType() & THEN_SYM)
+        if ((lexer.GetTokenType() & THEN_SYM) && FoldCondition(cond, condition, value))
+        {
+            // 条件恒真/恒假: 只保留会执行的分支，不生成跳转
+            lexer.GetWord();
+            size_t mark = pcodelist.code_list.size();
+            thenPart = statement();
+            if (!value)
+                thenPart = DropCode(mark);
+            if (lexer.GetTokenType() & ELSE_SYM)
+            {
+                lexer.GetWord();
+                mark = pcodelist.code_list.size();
+                elsePart = statement();
+                if (value)
+                    elsePart = DropCode(mark);
+            }
+            return value ? thenPart : elsePart;
+        }
+        else if (lexer.GetTokenType() & THEN_SYM)
         {
-            entry_jpc = pcodelist.emit(jpc, 0, 0);
+            entry_jpc = GenJump(jpc);
             lexer.GetWord();
-            statement();
+            thenPart = statement();
             if (lexer.GetTokenType() & ELSE_SYM)
             {
-                entry_jmp = pcodelist.emit(jmp, 0, 0);
+                entry_jmp = GenJump(jmp);
                 lexer.GetWord();
                 // 回填else入口地址
-                pcodelist.backpatch(entry_jpc, pcodelist.code_list.size());
-                statement();
+                GenPatch(entry_jpc);
+                elsePart = statement();
                 // 回填if结束地址
-                pcodelist.backpatch(entry_jmp, pcodelist.code_list.size());
+                GenPatch(entry_jmp);
             }
             else
-                pcodelist.backpatch(entry_jpc, pcodelist.code_list.size());
+                GenPatch(entry_jpc);
         }
         else if (lexer.GetTokenType() & firstStatement)
         {
-            entry_jpc = pcodelist.emit(jpc, 0, 0);
+            entry_jpc = GenJump(jpc);
             errorHandle.error(MISSING, L"then", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-            statement();
+            thenPart = statement();
             if (lexer.GetTokenType() & ELSE_SYM)
             {
-                entry_jmp = pcodelist.emit(jmp, 0, 0);
+                entry_jmp = GenJump(jmp);
                 lexer.GetWord();
-                pcodelist.backpatch(entry_jpc, pcodelist.code_list.size());
-                statement();
-                pcodelist.backpatch(entry_jmp, pcodelist.code_list.size());
+                GenPatch(entry_jpc);
+                elsePart = statement();
+                GenPatch(entry_jmp);
             }
             else
-                pcodelist.backpatch(entry_jpc, pcodelist.code_list.size());
+                GenPatch(entry_jpc);
         }
         else if (lexer.GetTokenType() & ELSE_SYM)
         {
-            entry_jmp = pcodelist.emit(jmp, 0, 0);
+            entry_jmp = GenJump(jmp);
             lexer.GetWord();
-            statement();
-            pcodelist.backpatch(entry_jmp, pcodelist.code_list.size());
+            elsePart = statement();
+            GenPatch(entry_jmp);
         }
         else
             errorHandle.error(ILLEGAL_DEFINE, L"<if>", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
+        node = GenIf(cond, thenPart, elsePart, entry_jpc != -1, entry_jmp != -1);
     }
     // 循环语句: while <lexp> do <statement>
     else if (lexer.GetTokenType() == WHILE_SYM)
     {
         lexer.GetWord();
         size_t condition = pcodelist.code_list.size();
-        lexp();
+        AstNode* cond = lexp();
+        AstNode* loopBody = nullptr;
+        bool hasBody = false;
+        int value;
+        if (lexer.GetTokenType() == DO_SYM && FoldCondition(cond, condition, value))
+        {
+            // 条件恒假: 删除整个循环；恒真: 不求值条件，循环体末尾直接跳回
+            lexer.GetWord();
+            loopBody = statement();
+            if (!value)
+                return DropCode(condition);
+            GenJump(jmp, condition);
+            node = GenWhile(nullptr, loopBody, true);
+            if (node)
+                node->flags |= AST_NO_COND;
+            return node;
+        }
         // 条件为假时跳出循环
-        size_t loop = pcodelist.emit(jpc, 0, 0);
+        size_t loop = GenJump(jpc);
         if (lexer.GetTokenType() == DO_SYM)
         {
             lexer.GetWord();
-            statement();
+            loopBody = statement();
+            hasBody = true;
             // 跳回条件判断处
-            pcodelist.emit(jmp, 0, condition);
+            GenJump(jmp, condition);
         }
         else if (lexer.GetTokenType() & firstStatement)
         {
             errorHandle.error(MISSING, L"do", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-            statement();
-            pcodelist.emit(jmp, 0, condition);
+            loopBody = statement();
+            hasBody = true;
+            GenJump(jmp, condition);
         }
         else
             errorHandle.error(MISSING, L"do", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
         // 回填循环出口
-        pcodelist.backpatch(loop, pcodelist.code_list.size());
+        GenPatch(loop);
+        node = GenWhile(cond, loopBody, hasBody);
     }
     // 调用语句: call <id>([<exp>{,<exp>}])
     else if (lexer.GetTokenType() == CALL_SYM)
     {
         lexer.GetWord();
         ProcInfo *cur_info = nullptr;
+        AstList args;
+        bool hasCall = false;
         
         if (lexer.GetTokenType() & IDENT)
         {
-            int pos = symTable.SearchInfo(lexer.GetStrToken(), Category::PROCE);
+            int pos = symTable.SearchInfo(lexer.GetAtom(), Category::PROCE);
             if (pos == -1)
                 errorHandle.error(UNDECLARED_PROC, lexer.GetStrToken().c_str(), lexer.GetPreWordRow(),
                                   lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
@@ -265,10 +667,11 @@ void Parser::statement()
                 lexer.GetWord();
                 if (lexer.GetTokenType() & firstExp)
                 {
-                    exp();
+                    AstNode* value = exp();
                     // 传递实参
                     if (cur_info)
-                        pcodelist.emit(store, -1, ACT_PRE_REC_SIZE + cur_info->level + 1 + 1);
+                        value = GenArg(value, cur_info, 0);
+                    args.Append(value);
                     size_t i = 1;
                     while ((lexer.GetTokenType() & COMMA) || (lexer.GetTokenType() & firstExp))
                     {
@@ -279,22 +682,22 @@ void Parser::statement()
                                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                         if (lexer.GetTokenType() & firstExp)
                         {
-                            exp();
+                            AstNode* value = exp();
                             if (cur_info)
-                                pcodelist.emit(store, -1, ACT_PRE_REC_SIZE + cur_info->level + 1 + 1 + i++);
+                                value = GenArg(value, cur_info, i++);
+                            args.Append(value);
                         }
                         else
-                            exp();
+                            args.Append(exp());
                     }
                     // 检查参数个数
-                    if (cur_info && i != cur_info->formVarList.size())
+                    if (cur_info && i != cur_info->formVarCount)
                         errorHandle.error(INCOMPATIBLE_VAR_LIST, lexer.GetPreWordRow(),
                                           lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                     if (lexer.GetTokenType() & RPAREN)
                     {
                         lexer.GetWord();
-                        if (cur_info)
-                            pcodelist.emit(call, cur_info->level, cur_info->entry);
+                        hasCall = cur_info != nullptr;
                     }
                     else
                         errorHandle.error(MISSING, L")", lexer.GetPreWordRow(),
@@ -310,9 +713,10 @@ void Parser::statement()
             {
                 errorHandle.error(MISSING, L"(", lexer.GetPreWordRow(),
                                   lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                exp();
+                AstNode* value = exp();
                 if (cur_info)
-                    pcodelist.emit(store, -1, ACT_PRE_REC_SIZE + cur_info->level + 2);
+                    value = GenArg(value, cur_info, 0);
+                args.Append(value);
                 size_t i = 1;
                 while ((lexer.GetTokenType() & COMMA) || (lexer.GetTokenType() & firstExp))
                 {
@@ -323,21 +727,21 @@ void Parser::statement()
                                           lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                     if (lexer.GetTokenType() & firstExp)
                     {
-                        exp();
+                        AstNode* value = exp();
                         if (cur_info)
-                            pcodelist.emit(store, -1, ACT_PRE_REC_SIZE + cur_info->level + 2 + i++);
+                            value = GenArg(value, cur_info, i++);
+                        args.Append(value);
                     }
                     else
-                        exp();
+                        args.Append(exp());
                 }
-                if (cur_info && i != cur_info->formVarList.size())
+                if (cur_info && i != cur_info->formVarCount)
                     errorHandle.error(INCOMPATIBLE_VAR_LIST, lexer.GetPreWordRow(),
                                       lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                 if (lexer.GetTokenType() & RPAREN)
                 {
                     lexer.GetWord();
-                    if (cur_info)
-                        pcodelist.emit(call, cur_info->level, cur_info->entry);
+                    hasCall = cur_info != nullptr;
                 }
                 else
                     errorHandle.error(MISSING, L")", lexer.GetPreWordRow(),
@@ -351,7 +755,7 @@ void Parser::statement()
             lexer.GetWord();
             if (lexer.GetTokenType() & firstExp)
             {
-                exp();
+                args.Append(exp());
                 while ((lexer.GetTokenType() & COMMA) || (lexer.GetTokenType() & firstExp))
                 {
                     if (lexer.GetTokenType() & COMMA)
@@ -359,7 +763,7 @@ void Parser::statement()
                     else
                         errorHandle.error(MISSING, L",", lexer.GetPreWordRow(),
                                           lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                    exp();
+                    args.Append(exp());
                 }
 
                 if (lexer.GetTokenType() & RPAREN)
@@ -383,20 +787,22 @@ void Parser::statement()
         else
             errorHandle.error(ILLEGAL_DEFINE, L"<call>", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
+        node = GenCall(args.head, cur_info, hasCall);
     }
     // 复合语句
     else if (lexer.GetTokenType() == BEGIN_SYM)
-        body();
+        node = body();
     // 读语句: read (<id>{,<id>})
     else if (lexer.GetTokenType() == READ_SYM)
     {
+        AstList targets;
         lexer.GetWord();
         if (lexer.GetTokenType() == LPAREN)
         {
             lexer.GetWord();
             if (lexer.GetTokenType() & IDENT)
             {
-                int pos = symTable.SearchInfo(lexer.GetStrToken(), Category::VAR);
+                int pos = symTable.SearchInfo(lexer.GetAtom(), Category::VAR);
                 VarInfo *cur_info = nullptr;
                 if (pos == -1)
                     errorHandle.error(UNDECLARED_PROC, lexer.GetStrToken().c_str(), lexer.GetPreWordRow(),
@@ -408,8 +814,7 @@ void Parser::statement()
                     if (cur_info->cat == Category::CST)
                         errorHandle.error(ILLEGAL_RVALUE_ASSIGN, lexer.GetPreWordRow(),
                                           lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                    pcodelist.emit(red, 0, 0);
-                    pcodelist.emit(store, cur_info->level, cur_info->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + cur_info->level + 1);
+                    targets.Append(GenReadVar(cur_info));
                 }
                 lexer.GetWord();
                 while (lexer.GetTokenType() & COMMA)
@@ -417,7 +822,7 @@ void Parser::statement()
                     lexer.GetWord();
                     if (lexer.GetTokenType() & IDENT)
                     {
-                        int pos1 = symTable.SearchInfo(lexer.GetStrToken(), Category::VAR);
+                        int pos1 = symTable.SearchInfo(lexer.GetAtom(), Category::VAR);
                         VarInfo *cur_info1 = nullptr;
                         if (pos1 == -1)
                             errorHandle.error(UNDECLARED_PROC, lexer.GetStrToken().c_str(), lexer.GetPreWordRow(),
@@ -429,8 +834,7 @@ void Parser::statement()
                             if (cur_info1->cat == Category::CST)
                                 errorHandle.error(ILLEGAL_RVALUE_ASSIGN, lexer.GetPreWordRow(),
                                                   lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                            pcodelist.emit(red, 0, 0);
-                            pcodelist.emit(store, cur_info1->level, cur_info1->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + cur_info1->level + 1);
+                            targets.Append(GenReadVar(cur_info1));
                         }
                         lexer.GetWord();
                     }
@@ -465,7 +869,7 @@ void Parser::statement()
                     lexer.GetWord();
                     if (lexer.GetTokenType() & IDENT)
                     {
-                        int pos = symTable.SearchInfo(lexer.GetStrToken(), Category::VAR);
+                        int pos = symTable.SearchInfo(lexer.GetAtom(), Category::VAR);
                         VarInfo *cur_info = nullptr;
                         if (pos == -1)
                             errorHandle.error(UNDECLARED_PROC, lexer.GetStrToken().c_str(), lexer.GetPreWordRow(),
@@ -477,8 +881,7 @@ void Parser::statement()
                             if (cur_info->cat == Category::CST)
                                 errorHandle.error(ILLEGAL_RVALUE_ASSIGN, lexer.GetPreWordRow(),
                                                   lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                            pcodelist.emit(red, 0, 0);
-                            pcodelist.emit(store, cur_info->level, cur_info->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + cur_info->level + 1);
+                            targets.Append(GenReadVar(cur_info));
                         }
                         lexer.GetWord();
                     }
@@ -507,7 +910,7 @@ void Parser::statement()
         {
             errorHandle.error(MISSING, L"(", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-            int pos = symTable.SearchInfo(lexer.GetStrToken(), Category::VAR);
+            int pos = symTable.SearchInfo(lexer.GetAtom(), Category::VAR);
             VarInfo *cur_info = nullptr;
             if (pos == -1)
                 errorHandle.error(UNDECLARED_PROC, lexer.GetStrToken().c_str(), lexer.GetPreWordRow(),
@@ -519,8 +922,7 @@ void Parser::statement()
                 if (cur_info->cat == Category::CST)
                     errorHandle.error(ILLEGAL_RVALUE_ASSIGN, lexer.GetPreWordRow(),
                                       lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                pcodelist.emit(red, 0, 0);
-                pcodelist.emit(store, cur_info->level, cur_info->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + cur_info->level + 1);
+                targets.Append(GenReadVar(cur_info));
             }
             lexer.GetWord();
             while (lexer.GetTokenType() & COMMA)
@@ -528,7 +930,7 @@ void Parser::statement()
                 lexer.GetWord();
                 if (lexer.GetTokenType() & IDENT)
                 {
-                    int pos1 = symTable.SearchInfo(lexer.GetStrToken(), Category::VAR);
+                    int pos1 = symTable.SearchInfo(lexer.GetAtom(), Category::VAR);
                     VarInfo *cur_info1 = nullptr;
                     if (pos1 == -1)
                         errorHandle.error(UNDECLARED_PROC, lexer.GetStrToken().c_str(), lexer.GetPreWordRow(),
@@ -540,8 +942,7 @@ void Parser::statement()
                         if (cur_info1->cat == Category::CST)
                             errorHandle.error(ILLEGAL_RVALUE_ASSIGN, lexer.GetPreWordRow(),
                                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                        pcodelist.emit(red, 0, 0);
-                        pcodelist.emit(store, cur_info1->level, cur_info1->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + cur_info1->level + 1);
+                        targets.Append(GenReadVar(cur_info1));
                     }
                     lexer.GetWord();
                 }
@@ -577,7 +978,7 @@ void Parser::statement()
                 lexer.GetWord();
                 if (lexer.GetTokenType() & IDENT)
                 {
-                    int pos = symTable.SearchInfo(lexer.GetStrToken(), Category::VAR);
+                    int pos = symTable.SearchInfo(lexer.GetAtom(), Category::VAR);
                     VarInfo *cur_info = nullptr;
                     if (pos == -1)
                         errorHandle.error(UNDECLARED_PROC, lexer.GetStrToken().c_str(), lexer.GetPreWordRow(),
@@ -589,8 +990,7 @@ void Parser::statement()
                         if (cur_info->cat == Category::CST)
                             errorHandle.error(ILLEGAL_RVALUE_ASSIGN, lexer.GetPreWordRow(),
                                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                        pcodelist.emit(red, 0, 0);
-                        pcodelist.emit(store, cur_info->level, cur_info->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + cur_info->level + 1);
+                        targets.Append(GenReadVar(cur_info));
                     }
                     lexer.GetWord();
                 }
@@ -612,18 +1012,19 @@ void Parser::statement()
         }
         else
             judge(0, followStatement, ILLEGAL_DEFINE, L"<read>");
+        node = GenRead(targets.head);
     }
     // 写语句: write (<exp>{,<exp>})
     else if (lexer.GetTokenType() == WRITE_SYM)
     {
+        AstList items;
         lexer.GetWord();
         if (lexer.GetTokenType() & LPAREN)
         {
             lexer.GetWord();
             if (lexer.GetTokenType() & firstExp)
             {
-                exp();
-                pcodelist.emit(wrt, 0, 0);
+                items.Append(GenPrint(exp()));
                 while ((lexer.GetTokenType() & COMMA) || (lexer.GetTokenType() & firstExp))
                 {
                     if (lexer.GetTokenType() & COMMA)
@@ -633,11 +1034,10 @@ void Parser::statement()
                                           lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                     if (lexer.GetTokenType() & firstExp)
                     {
-                        exp();
-                        pcodelist.emit(wrt, 0, 0);
+                        items.Append(GenPrint(exp()));
                     }
                     else
-                        exp();
+                        items.Append(exp());
                 }
                 if (lexer.GetTokenType() & RPAREN)
                     lexer.GetWord();
@@ -664,11 +1064,10 @@ void Parser::statement()
                                           lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                     if (lexer.GetTokenType() & firstExp)
                     {
-                        exp();
-                        pcodelist.emit(wrt, 0, 0);
+                        items.Append(GenPrint(exp()));
                     }
                     else
-                        exp();
+                        items.Append(exp());
                 }
                 if (lexer.GetTokenType() & RPAREN)
                     lexer.GetWord();
@@ -684,8 +1083,7 @@ void Parser::statement()
         {
             errorHandle.error(MISSING, L"(", lexer.GetPreWordRow(),
                               lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-            exp();
-            pcodelist.emit(wrt, 0, 0);
+            items.Append(GenPrint(exp()));
             while ((lexer.GetTokenType() & COMMA) || (lexer.GetTokenType() & firstExp))
             {
                 if (lexer.GetTokenType() & COMMA)
@@ -695,11 +1093,10 @@ void Parser::statement()
                                       lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                 if (lexer.GetTokenType() & firstExp)
                 {
-                    exp();
-                    pcodelist.emit(wrt, 0, 0);
+                    items.Append(GenPrint(exp()));
                 }
                 else
-                    exp();
+                    items.Append(exp());
             }
             if (lexer.GetTokenType() & RPAREN)
                 lexer.GetWord();
@@ -726,11 +1123,10 @@ void Parser::statement()
                                       lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                 if (lexer.GetTokenType() & firstExp)
                 {
-                    exp();
-                    pcodelist.emit(wrt, 0, 0);
+                    items.Append(GenPrint(exp()));
                 }
                 else
-                    exp();
+                    items.Append(exp());
             }
             if (lexer.GetTokenType() & RPAREN)
                 lexer.GetWord();
@@ -741,18 +1137,30 @@ void Parser::statement()
         else
             judge(0, followStatement, ILLEGAL_DEFINE, L"<write>");
         // 输出换行
-        pcodelist.emit(opr, 0, 13);
+        node = GenWrite(items.head);
     }
     else
         judge(0, followStatement, ILLEGAL_DEFINE, L"statement");
+    return node;
 }
 
 /**
  * @brief 表达式处理
+ * @details 默认使用显式栈分析，嵌套深度只受堆内存限制；
+ *          设置递归下降时经exp/term/factor相互递归分析，两种方式的结果与诊断完全相同
+ */
+AstNode* Parser::exp()
+{
+    return recursiveExp ? expRecursive() : expExplicit();
+}
+
+/**
+ * @brief 递归下降的表达式处理
  * @details 文法: <exp> → [+|-]<term>{<aop><term>}
  */
-void Parser::exp()
+AstNode* Parser::expRecursive()
 {
+    AstNode* node = nullptr;
     unsigned long aop = NUL;
     if (lexer.GetTokenType() & firstExp)
     {
@@ -765,10 +1173,10 @@ void Parser::exp()
 
         if (lexer.GetTokenType() & firstTerm)
         {
-            term();
+            node = term();
             // 负号取反
             if (aop & MINUS)
-                pcodelist.emit(opr, 0, OPR_NEGTIVE);
+                node = GenUnary(OPR_NEGTIVE, node);
             // 处理加减运算
             while (lexer.GetTokenType() & (PLUS | MINUS))
             {
@@ -776,11 +1184,8 @@ void Parser::exp()
                 lexer.GetWord();
                 if (lexer.GetTokenType() & firstTerm)
                 {
-                    term();
-                    if (aop == MINUS)
-                        pcodelist.emit(opr, 0, OPR_SUB);
-                    else
-                        pcodelist.emit(opr, 0, OPR_ADD);
+                    AstNode* rhs = term();
+                    node = GenBinary(aop == MINUS ? OPR_SUB : OPR_ADD, node, rhs);
                 }
                 else
                     errorHandle.error(REDUNDENT, lexer.GetStrToken().c_str(), lexer.GetPreWordRow(),
@@ -790,17 +1195,164 @@ void Parser::exp()
     }
     else
         judge(0, followExp, ILLEGAL_DEFINE, L"expression (invalid expression start)");
+    return node;
+}
+
+/**
+ * @brief 显式栈的表达式处理
+ * @details 把exp/term/factor的相互递归展开为下推自动机: 每层括号在expStack上占一帧，
+ *          记录本层已归约的表达式、当前项与待归约的运算符；遇到'('压入新帧，
+ *          本层表达式结束时弹出并回到外层因子之后。各状态的判断、报错与生成顺序
+ *          与递归版本逐一对应，生成相同的OPR序列
+ */
+AstNode* Parser::expExplicit()
+{
+    enum { EXP_BEGIN, TERM_BEGIN, FACTOR_BEGIN, FACTOR_DONE, TERM_DONE, EXP_DONE } state = EXP_BEGIN;
+    size_t base = expStack.size();
+    AstNode* result = nullptr;
+    expStack.push_back(ExpFrame());
+    while (true)
+    {
+        ExpFrame& top = expStack.back();
+        switch (state)
+        {
+        // <exp> → [+|-]<term>{<aop><term>}
+        case EXP_BEGIN:
+            state = EXP_DONE;
+            result = nullptr;
+            if (lexer.GetTokenType() & firstExp)
+            {
+                // 处理可选的正负号
+                if (lexer.GetTokenType() & (PLUS | MINUS))
+                {
+                    top.aop = lexer.GetTokenType();
+                    lexer.GetWord();
+                }
+                if (lexer.GetTokenType() & firstTerm)
+                {
+                    top.firstTerm = true;
+                    state = TERM_BEGIN;
+                }
+            }
+            else
+                judge(0, followExp, ILLEGAL_DEFINE, L"expression (invalid expression start)");
+            break;
+        // <term> → <factor>{<mop><factor>}
+        case TERM_BEGIN:
+            if (lexer.GetTokenType() & firstTerm)
+            {
+                top.firstFactor = true;
+                state = FACTOR_BEGIN;
+            }
+            else
+            {
+                judge(0, followTerm, ILLEGAL_DEFINE, L"term (invalid term start)");
+                result = nullptr;
+                state = TERM_DONE;
+            }
+            break;
+        // <factor> → <id> | <integer> | (<exp>)
+        case FACTOR_BEGIN:
+            if (lexer.GetTokenType() == IDENT || lexer.GetTokenType() == NUMBER)
+            {
+                result = operand();
+                state = FACTOR_DONE;
+            }
+            else if (lexer.GetTokenType() == LPAREN)
+            {
+                // 括号表达式: 压入新帧分析内层表达式
+                lexer.GetWord();
+                expStack.push_back(ExpFrame());
+                state = EXP_BEGIN;
+            }
+            else
+            {
+                judge(0, followFactor, ILLEGAL_DEFINE, L"factor");
+                result = nullptr;
+                state = FACTOR_DONE;
+            }
+            break;
+        case FACTOR_DONE:
+            top.term = top.firstFactor ? result
+                                       : GenBinary(top.nop == MULTI ? OPR_MULTI : OPR_DIVIS, top.term, result);
+            top.firstFactor = false;
+            state = TERM_DONE;
+            // 处理乘除运算
+            while (lexer.GetTokenType() & (MULTI | DIVIS))
+            {
+                top.nop = lexer.GetTokenType();
+                lexer.GetWord();
+                if (lexer.GetTokenType() & firstFactor)
+                {
+                    state = FACTOR_BEGIN;
+                    break;
+                }
+                else if (lexer.GetTokenType() & (MULTI | DIVIS))
+                    errorHandle.error(SYNTAX_ERROR, L"<factor>",
+                                      L"Two consecutive operators found. Expected a <factor> after '*' or '/'.",
+                                      lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
+                else
+                    errorHandle.error(EXPECT, L"a valid <factor> after '*' or '/'.",
+                                      lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
+            }
+            if (state == TERM_DONE)
+                result = top.term;
+            break;
+        case TERM_DONE:
+            if (top.firstTerm)
+            {
+                top.exp = result;
+                // 负号取反
+                if (top.aop & MINUS)
+                    top.exp = GenUnary(OPR_NEGTIVE, top.exp);
+            }
+            else
+                top.exp = GenBinary(top.aop == MINUS ? OPR_SUB : OPR_ADD, top.exp, result);
+            top.firstTerm = false;
+            state = EXP_DONE;
+            // 处理加减运算
+            while (lexer.GetTokenType() & (PLUS | MINUS))
+            {
+                top.aop = lexer.GetTokenType();
+                lexer.GetWord();
+                if (lexer.GetTokenType() & firstTerm)
+                {
+                    state = TERM_BEGIN;
+                    break;
+                }
+                else
+                    errorHandle.error(REDUNDENT, lexer.GetStrToken().c_str(), lexer.GetPreWordRow(),
+                                      lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
+            }
+            if (state == EXP_DONE)
+                result = top.exp;
+            break;
+        case EXP_DONE:
+            expStack.pop_back();
+            if (expStack.size() == base)
+                return result;
+            // 回到外层的括号因子
+            if (lexer.GetTokenType() == RPAREN)
+                lexer.GetWord();
+            else
+                errorHandle.error(MISSING, L"')'",
+                                  lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
+            state = FACTOR_DONE;
+            break;
+        }
+    }
 }
 
 /**
  * @brief 项处理
  * @details 文法: <term> → <factor>{<mop><factor>}
  */
-void Parser::term()
+AstNode* Parser::term()
 {
+    AstNode* node = nullptr;
     if (lexer.GetTokenType() & firstTerm)
     {
-        factor();
+        node = factor();
         // 处理乘除运算
         while (lexer.GetTokenType() & (MULTI | DIVIS))
         {
@@ -808,11 +1360,8 @@ void Parser::term()
             lexer.GetWord();
             if (lexer.GetTokenType() & firstFactor)
             {
-                factor();
-                if (nop == MULTI)
-                    pcodelist.emit(opr, 0, OPR_MULTI);
-                else
-                    pcodelist.emit(opr, 0, OPR_DIVIS);
+                AstNode* rhs = factor();
+                node = GenBinary(nop == MULTI ? OPR_MULTI : OPR_DIVIS, node, rhs);
             }
             else if (lexer.GetTokenType() & (MULTI | DIVIS))
                 errorHandle.error(SYNTAX_ERROR, L"<factor>",
@@ -825,18 +1374,46 @@ void Parser::term()
     }
     else
         judge(0, followTerm, ILLEGAL_DEFINE, L"term (invalid term start)");
+    return node;
 }
 
 /**
  * @brief 因子处理
  * @details 文法: <factor> → <id> | <integer> | (<exp>)
  */
-void Parser::factor()
+AstNode* Parser::factor()
+{
+    AstNode* node = nullptr;
+    // 标识符或数字常量
+    if (lexer.GetTokenType() == IDENT || lexer.GetTokenType() == NUMBER)
+        node = operand();
+    // 括号表达式
+    else if (lexer.GetTokenType() == LPAREN)
+    {
+        lexer.GetWord();
+        node = exp();
+        if (lexer.GetTokenType() == RPAREN)
+            lexer.GetWord();
+        else
+            errorHandle.error(MISSING, L"')'",
+                              lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
+    }
+    else
+        judge(0, followFactor, ILLEGAL_DEFINE, L"factor");
+    return node;
+}
+
+/**
+ * @brief 标识符或数字常量因子
+ * @details 调用前当前词法单元为IDENT或NUMBER
+ */
+AstNode* Parser::operand()
 {
+    AstNode* node = nullptr;
     // 标识符
     if (lexer.GetTokenType() == IDENT)
     {
-        int pos = symTable.SearchInfo(lexer.GetStrToken(), Category::VAR);
+        int pos = symTable.SearchInfo(lexer.GetAtom(), Category::VAR);
         VarInfo *cur_info = nullptr;
         if (pos == -1)
             errorHandle.error(UNDECLARED_IDENT, lexer.GetStrToken().c_str(),
@@ -849,45 +1426,34 @@ void Parser::factor()
             if (cur_info->cat == Category::CST)
             {
                 int val = cur_info->GetValue();
-                pcodelist.emit(lit, cur_info->level, val);
+                node = GenLit(cur_info->level, val);
             }
             // 变量从内存加载
             else
-                pcodelist.emit(load, cur_info->level, cur_info->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + cur_info->level + 1);
+                node = GenLoad(cur_info->level, cur_info->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + cur_info->level + 1);
         }
         lexer.GetWord();
     }
     // 数字常量
-    else if (lexer.GetTokenType() == NUMBER)
+    else
     {
-        pcodelist.emit(lit, 0, w_str2int(lexer.GetStrToken()));
+        node = GenLit(0, w_str2int(lexer.GetStrToken()));
         lexer.GetWord();
     }
-    // 括号表达式
-    else if (lexer.GetTokenType() == LPAREN)
-    {
-        lexer.GetWord();
-        exp();
-        if (lexer.GetTokenType() == RPAREN)
-            lexer.GetWord();
-        else
-            errorHandle.error(MISSING, L"')'",
-                              lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-    }
-    else
-        judge(0, followFactor, ILLEGAL_DEFINE, L"factor");
+    return node;
 }
 
 /**
  * @brief 复合语句处理
  * @details 文法: <body> → begin <statement>{;<statement>} end
  */
-void Parser::body()
+AstNode* Parser::body()
 {
+    AstList statements;
     if (lexer.GetTokenType() == BEGIN_SYM)
     {
         lexer.GetWord();
-        statement();
+        statements.Append(statement());
         while ((lexer.GetTokenType() & SEMICOLON) || (lexer.GetTokenType() & firstStatement))
         {
             if (lexer.GetTokenType() & SEMICOLON)
@@ -895,7 +1461,7 @@ void Parser::body()
             else
                 errorHandle.error(MISSING, L";", lexer.GetPreWordRow(),
                                   lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-            statement();
+            statements.Append(statement());
         }
         if (lexer.GetTokenType() & END_SYM)
             lexer.GetWord();
@@ -914,7 +1480,7 @@ void Parser::body()
             else
                 errorHandle.error(MISSING, L";", lexer.GetPreWordRow(),
                                   lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-            statement();
+            statements.Append(statement());
         }
         if (lexer.GetTokenType() & END_SYM)
             lexer.GetWord();
@@ -929,43 +1495,45 @@ void Parser::body()
     }
     else
         judge(0, followBody, ILLEGAL_DEFINE, L"'<body>'");
+    return GenSeq(statements.head);
 }
 
 /**
  * @brief 条件表达式处理
  * @details 文法: <lexp> → <exp> <lop> <exp> | odd <exp>
  */
-void Parser::lexp()
+AstNode* Parser::lexp()
 {
+    AstNode* node = nullptr;
     if (lexer.GetTokenType() & firstExp)
     {
-        exp();
+        node = exp();
         // 检查关系运算符
         if (lexer.GetTokenType() & (EQL | NEQ | LSS | LEQ | GRT | GEQ))
         {
             unsigned int lop = lexer.GetTokenType();
             lexer.GetWord();
-            exp();
+            AstNode* rhs = exp();
             // 生成比较指令
             switch (lop)
             {
             case LSS:
-                pcodelist.emit(opr, 0, OPR_LSS);
+                node = GenBinary(OPR_LSS, node, rhs);
                 break;
             case LEQ:
-                pcodelist.emit(opr, 0, OPR_LEQ);
+                node = GenBinary(OPR_LEQ, node, rhs);
                 break;
             case GRT:
-                pcodelist.emit(opr, 0, OPR_GRT);
+                node = GenBinary(OPR_GRT, node, rhs);
                 break;
             case GEQ:
-                pcodelist.emit(opr, 0, OPR_GEQ);
+                node = GenBinary(OPR_GEQ, node, rhs);
                 break;
             case NEQ:
-                pcodelist.emit(opr, 0, OPR_NEQ);
+                node = GenBinary(OPR_NEQ, node, rhs);
                 break;
             case EQL:
-                pcodelist.emit(opr, 0, OPR_EQL);
+                node = GenBinary(OPR_EQL, node, rhs);
                 break;
             default:
                 break;
@@ -977,7 +1545,8 @@ void Parser::lexp()
                               L"Expected a logical operator (e.g., '=', '<>', '<') after the expression.",
                               lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
             lexer.GetWord();
-            exp();
+            AstNode* rhs = exp();
+            node = GenBinary(OPR_NONE, node, rhs);
         }
     }
     // odd表达式
@@ -986,14 +1555,14 @@ void Parser::lexp()
         lexer.GetWord();
         if (lexer.GetTokenType() & firstExp)
         {
-            exp();
-            pcodelist.emit(opr, 0, OPR_ODD);
+            node = GenUnary(OPR_ODD, exp());
         }
         else
             errorHandle.error(EXPECT, L"expression", lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
     }
     else
         judge(0, followLexp, ILLEGAL_DEFINE, L"lexp (invalid logical expression start)");
+    return node;
 }
 
 /**
@@ -1007,7 +1576,7 @@ void Parser::vardecl()
         lexer.GetWord();
         if (lexer.GetTokenType() & IDENT)
         {
-            symTable.InsertToTable(lexer.GetStrToken(), glo_offset, Category::VAR);
+            symTable.InsertToTable(lexer.GetAtom(), glo_offset, Category::VAR);
             glo_offset += 4;
             lexer.GetWord();
             while (lexer.GetTokenType() == COMMA)
@@ -1015,7 +1584,7 @@ void Parser::vardecl()
                 lexer.GetWord();
                 if (lexer.GetTokenType() & IDENT)
                 {
-                    symTable.InsertToTable(lexer.GetStrToken(), glo_offset, Category::VAR);
+                    symTable.InsertToTable(lexer.GetAtom(), glo_offset, Category::VAR);
                     glo_offset += 4;
                     lexer.GetWord();
                 }
@@ -1037,7 +1606,7 @@ void Parser::vardecl()
                 lexer.GetWord();
                 if (lexer.GetTokenType() & IDENT)
                 {
-                    symTable.InsertToTable(lexer.GetStrToken(), glo_offset, Category::VAR);
+                    symTable.InsertToTable(lexer.GetAtom(), glo_offset, Category::VAR);
                     glo_offset += 4;
                     lexer.GetWord();
                 }
@@ -1071,7 +1640,7 @@ void Parser::constA()
 {
     if (lexer.GetTokenType() == IDENT)
     {
-        symTable.InsertToTable(lexer.GetStrToken(), 0, CST);
+        symTable.InsertToTable(lexer.GetAtom(), 0, CST);
         lexer.GetWord();
         if (lexer.GetTokenType() == ASSIGN)
             lexer.GetWord();
@@ -1171,33 +1740,32 @@ void Parser::proc()
     int flag = 0;
     if (lexer.GetTokenType() == PROC_SYM)
     {
+        AstNode* node = BeginProc();
         lexer.GetWord();
         ProcInfo *cur_info = nullptr;
         
         if (lexer.GetTokenType() == IDENT)
         {
             symTable.MkTable();
-            int cur_proc = symTable.InsertToTable(lexer.GetStrToken(), 0, Category::PROCE);
+            int cur_proc = symTable.InsertToTable(lexer.GetAtom(), 0, Category::PROCE);
             if (cur_proc != -1)
             {
                 cur_info = (ProcInfo *)symTable.table[cur_proc].info;
-                size_t entry = pcodelist.emit(jmp, 0, 0);
-                symTable.table[symTable.table.size() - 1].info->SetEntry(entry);
+                GenProcEntry(node, symTable.table[symTable.table.size() - 1].info);
             }
             lexer.GetWord();
             if (lexer.GetTokenType() & LPAREN)
             {
                 // 进入新层次
-                symTable.display.push_back(0);
-                symTable.level++;
+                symTable.PushDisplay();
 
                 lexer.GetWord();
                 if (lexer.GetTokenType() & IDENT)
                 {
-                    int form_var = symTable.InsertToTable(lexer.GetStrToken(), glo_offset, Category::FORM);
+                    int form_var = symTable.InsertToTable(lexer.GetAtom(), glo_offset, Category::FORM);
                     glo_offset += 4;
                     if (cur_info)
-                        cur_info->formVarList.push_back(form_var);
+                        symTable.AddFormVar(cur_info, form_var);
 
                     lexer.GetWord();
                     while ((lexer.GetTokenType() & COMMA) || (lexer.GetTokenType() & IDENT))
@@ -1209,10 +1777,10 @@ void Parser::proc()
                                               lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                         if (lexer.GetTokenType() & IDENT)
                         {
-                            int form_var = symTable.InsertToTable(lexer.GetStrToken(), glo_offset, Category::FORM);
+                            int form_var = symTable.InsertToTable(lexer.GetAtom(), glo_offset, Category::FORM);
                             glo_offset += 4;
                             if (cur_info)
-                                cur_info->formVarList.push_back(form_var);
+                                symTable.AddFormVar(cur_info, form_var);
                             lexer.GetWord();
                         }
                         else
@@ -1226,12 +1794,10 @@ void Parser::proc()
                     if (lexer.GetTokenType() & SEMICOLON)
                     {
                         lexer.GetWord();
-                        block();
-                        // 生成返回指令
-                        pcodelist.emit(opr, 0, OPR_RETURN);
+                        // 分程序之后生成返回指令
+                        GenReturn(node, block());
                         // 退出当前层次
-                        symTable.display.pop_back();
-                        symTable.level--;
+                        symTable.PopDisplay();
 
                         while (lexer.GetTokenType() & SEMICOLON)
                         {
@@ -1243,10 +1809,8 @@ void Parser::proc()
                     {
                         errorHandle.error(MISSING, L"';'",
                                           lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                        block();
-                        pcodelist.emit(opr, 0, OPR_RETURN);
-                        symTable.display.pop_back();
-                        symTable.level--;
+                        GenReturn(node, block());
+                        symTable.PopDisplay();
                         while (lexer.GetTokenType() & SEMICOLON)
                         {
                             lexer.GetWord();
@@ -1257,13 +1821,12 @@ void Parser::proc()
             }
             else if (lexer.GetTokenType() & IDENT)
             {
-                symTable.display.push_back(0);
-                symTable.level++;
+                symTable.PushDisplay();
 
-                int form_var = symTable.InsertToTable(lexer.GetStrToken(), glo_offset, Category::FORM);
+                int form_var = symTable.InsertToTable(lexer.GetAtom(), glo_offset, Category::FORM);
                 glo_offset += 4;
                 if (cur_info)
-                    cur_info->formVarList.push_back(form_var);
+                    symTable.AddFormVar(cur_info, form_var);
                 errorHandle.error(MISSING, L"'('",
                                   lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                 lexer.GetWord();
@@ -1276,10 +1839,10 @@ void Parser::proc()
                                           lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                     if (lexer.GetTokenType() & IDENT)
                     {
-                        int form_var = symTable.InsertToTable(lexer.GetStrToken(), glo_offset, Category::FORM);
+                        int form_var = symTable.InsertToTable(lexer.GetAtom(), glo_offset, Category::FORM);
                         glo_offset += 4;
                         if (cur_info)
-                            cur_info->formVarList.push_back(form_var);
+                            symTable.AddFormVar(cur_info, form_var);
                         lexer.GetWord();
                     }
                     else
@@ -1292,10 +1855,8 @@ void Parser::proc()
                     if (lexer.GetTokenType() & SEMICOLON)
                     {
                         lexer.GetWord();
-                        block();
-                        pcodelist.emit(opr, 0, OPR_RETURN);
-                        symTable.display.pop_back();
-                        symTable.level--;
+                        GenReturn(node, block());
+                        symTable.PopDisplay();
 
                         while (lexer.GetTokenType() & SEMICOLON)
                         {
@@ -1307,10 +1868,8 @@ void Parser::proc()
                     {
                         errorHandle.error(MISSING, L"';'",
                                           lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                        block();
-                        pcodelist.emit(opr, 0, OPR_RETURN);
-                        symTable.display.pop_back();
-                        symTable.level--;
+                        GenReturn(node, block());
+                        symTable.PopDisplay();
 
                         while (lexer.GetTokenType() & SEMICOLON)
                         {
@@ -1322,8 +1881,7 @@ void Parser::proc()
             }
             else if (lexer.GetTokenType() & RPAREN)
             {
-                symTable.display.push_back(0);
-                symTable.level++;
+                symTable.PushDisplay();
 
                 errorHandle.error(MISSING, L"'('",
                                   lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
@@ -1331,10 +1889,8 @@ void Parser::proc()
                 if (lexer.GetTokenType() & SEMICOLON)
                 {
                     lexer.GetWord();
-                    block();
-                    pcodelist.emit(opr, 0, OPR_RETURN);
-                    symTable.level--;
-                    symTable.display.pop_back();
+                    GenReturn(node, block());
+                    symTable.PopDisplay();
                     while (lexer.GetTokenType() & SEMICOLON)
                     {
                         lexer.GetWord();
@@ -1345,10 +1901,8 @@ void Parser::proc()
                 {
                     errorHandle.error(MISSING, L"';'",
                                       lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                    block();
-                    pcodelist.emit(opr, 0, OPR_RETURN);
-                    symTable.level--;
-                    symTable.display.pop_back();
+                    GenReturn(node, block());
+                    symTable.PopDisplay();
                     while (lexer.GetTokenType() & SEMICOLON)
                     {
                         lexer.GetWord();
@@ -1360,25 +1914,23 @@ void Parser::proc()
         else if (lexer.GetTokenType() & LPAREN)
         {
             symTable.MkTable();
-            int cur_proc = symTable.InsertToTable(L"null", 0, Category::PROCE);
+            int cur_proc = symTable.InsertToTable(atomTable.Intern(L"null"), 0, Category::PROCE);
             if (cur_proc != -1)
             {
                 cur_info = (ProcInfo *)symTable.table[cur_proc].info;
-                size_t entry = pcodelist.emit(jmp, 0, 0);
-                symTable.table[symTable.table.size() - 1].info->SetEntry(entry);
+                GenProcEntry(node, symTable.table[symTable.table.size() - 1].info);
             }
-            symTable.display.push_back(0);
-            symTable.level++;
+            symTable.PushDisplay();
             errorHandle.error(MISSING, L"'<id>'",
                               lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
 
             lexer.GetWord();
             if (lexer.GetTokenType() & IDENT)
             {
-                int form_var = symTable.InsertToTable(lexer.GetStrToken(), glo_offset, Category::FORM);
+                int form_var = symTable.InsertToTable(lexer.GetAtom(), glo_offset, Category::FORM);
                 glo_offset += 4;
                 if (cur_info)
-                    cur_info->formVarList.push_back(form_var);
+                    symTable.AddFormVar(cur_info, form_var);
                 lexer.GetWord();
                 while ((lexer.GetTokenType() & COMMA) || (lexer.GetTokenType() & IDENT))
                 {
@@ -1389,10 +1941,10 @@ void Parser::proc()
                                           lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
                     if (lexer.GetTokenType() & IDENT)
                     {
-                        int form_var = symTable.InsertToTable(lexer.GetStrToken(), glo_offset, Category::FORM);
+                        int form_var = symTable.InsertToTable(lexer.GetAtom(), glo_offset, Category::FORM);
                         glo_offset += 4;
                         if (cur_info)
-                            cur_info->formVarList.push_back(form_var);
+                            symTable.AddFormVar(cur_info, form_var);
                         lexer.GetWord();
                     }
                     else
@@ -1406,10 +1958,8 @@ void Parser::proc()
                 if (lexer.GetTokenType() & SEMICOLON)
                 {
                     lexer.GetWord();
-                    block();
-                    pcodelist.emit(opr, 0, OPR_RETURN);
-                    symTable.level--;
-                    symTable.display.pop_back();
+                    GenReturn(node, block());
+                    symTable.PopDisplay();
                     while (lexer.GetTokenType() & SEMICOLON)
                     {
                         lexer.GetWord();
@@ -1420,10 +1970,8 @@ void Parser::proc()
                 {
                     errorHandle.error(MISSING, L"';'",
                                       lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-                    block();
-                    pcodelist.emit(opr, 0, OPR_RETURN);
-                    symTable.level--;
-                    symTable.display.pop_back();
+                    GenReturn(node, block());
+                    symTable.PopDisplay();
                     while (lexer.GetTokenType() & SEMICOLON)
                     {
                         lexer.GetWord();
@@ -1441,8 +1989,9 @@ void Parser::proc()
  * @brief 分程序处理
  * @details 文法: <block> → [<condecl>][<vardecl>][<proc>]<body>
  */
-void Parser::block()
+AstNode* Parser::block()
 {
+    AstNode* node = nullptr;
     int r = judge(firstBlock, followBlock, MISSING, L"body");
     if (r == 1)
     {
@@ -1457,24 +2006,45 @@ void Parser::block()
         size_t cur_proc = symTable.sp;
         ProcInfo *cur_info = (ProcInfo *)symTable.table[cur_proc].info;
         symTable.AddWidth(cur_proc, glo_offset);
+        glo_offset = 0;
         
-        // 过程声明
+        // 过程声明(语法树模式下追加到本分程序的过程列表)
+        AstNode** outer = procTail;
+        if (buildAst)
+        {
+            node = NewNode(AST_BLOCK);
+            procTail = &node->left;
+        }
         if (lexer.GetTokenType() & firstProc)
             proc();
+        procTail = outer;
         
         // 生成分配空间指令
-        size_t entry = pcodelist.emit(alloc, 0, cur_info->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + symTable.level + 1);
-        size_t target = cur_info->entry;
-        // 回填过程入口地址
-        pcodelist.backpatch(target, entry);
+        int size = cur_info->offset / UNIT_SIZE + ACT_PRE_REC_SIZE + symTable.level + 1;
+        if (buildAst)
+        {
+            // 入口地址在降级时回填
+            node->a = size;
+            node->info = cur_info;
+        }
+        else
+        {
+            size_t entry = pcodelist.emit(alloc, 0, size);
+            size_t target = cur_info->entry;
+            // 回填过程入口地址
+            pcodelist.backpatch(target, entry);
+        }
         
         // 标记过程已定义
         if (cur_proc)
             cur_info->isDefined = true;
         
         // 复合语句
-        body();
+        AstNode* statements = body();
+        if (node)
+            node->right = statements;
     }
+    return node;
 }
 
 /**
@@ -1483,6 +2053,7 @@ void Parser::block()
  */
 void Parser::prog()
 {
+    AstNode* node = BeginProc();
     int r = judge(PROGM_SYM, IDENT | SEMICOLON | firstBlock, MISSING, L"program");
     if (r == 1)
         lexer.GetWord();
@@ -1490,15 +2061,13 @@ void Parser::prog()
     if (lexer.GetTokenType() == IDENT)
     {
         symTable.MkTable();
-        symTable.EnterProgm(lexer.GetStrToken());
+        symTable.EnterProgm(lexer.GetAtom());
         lexer.GetWord();
         if (lexer.GetTokenType() == SEMICOLON)
         {
             lexer.GetWord();
-            size_t entry = pcodelist.emit(jmp, 0, 0);
-            symTable.table[0].info->SetEntry(entry);
-            block();
-            pcodelist.emit(opr, 0, OPR_RETURN);
+            GenProcEntry(node, symTable.table[0].info);
+            GenReturn(node, block());
             if (lexer.GetCh() != L'\0' && lexer.GetCh() != L'#')
                 errorHandle.error(ILLEGAL_WORD, (L"'" + lexer.GetStrToken() + L"'").c_str(),
                                   lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
@@ -1506,12 +2075,10 @@ void Parser::prog()
         }
         else
         {
-            size_t entry = pcodelist.emit(jmp, 0, 0);
-            symTable.table[0].info->SetEntry(entry);
+            GenProcEntry(node, symTable.table[0].info);
             errorHandle.error(MISSING, L";",
                               lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-            block();
-            pcodelist.emit(opr, 0, OPR_RETURN);
+            GenReturn(node, block());
             if (lexer.GetCh() != L'\0' && lexer.GetCh() != L'#')
                 errorHandle.error(ILLEGAL_WORD, (L"'" + lexer.GetStrToken() + L"'").c_str(),
                                   lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
@@ -1525,12 +2092,10 @@ void Parser::prog()
                           lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
 
         symTable.MkTable();
-        symTable.EnterProgm(L"null");
+        symTable.EnterProgm(atomTable.Intern(L"null"));
         lexer.GetWord();
-        size_t entry = pcodelist.emit(jmp, 0, 0);
-        symTable.table[0].info->SetEntry(entry);
-        block();
-        pcodelist.emit(opr, 0, OPR_RETURN);
+        GenProcEntry(node, symTable.table[0].info);
+        GenReturn(node, block());
         if (lexer.GetCh() != '\0' && lexer.GetCh() != L'#')
             errorHandle.error(ILLEGAL_WORD, (L"'" + lexer.GetStrToken() + L"'").c_str(),
                               lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
@@ -1540,13 +2105,11 @@ void Parser::prog()
     if (lexer.GetTokenType() & firstBlock)
     {
         symTable.MkTable();
-        symTable.EnterProgm(L"null");
+        symTable.EnterProgm(atomTable.Intern(L"null"));
         errorHandle.error(EXPECT_STH_FIND_ANTH, L"id", (L"'" + lexer.GetStrToken() + L"'").c_str(),
                           lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
-        size_t entry = pcodelist.emit(jmp, 0, 0);
-        symTable.table[0].info->SetEntry(entry);
-        block();
-        pcodelist.emit(opr, 0, OPR_RETURN);
+        GenProcEntry(node, symTable.table[0].info);
+        GenReturn(node, block());
         if (lexer.GetCh() != '\0' && lexer.GetCh() != L'#')
             errorHandle.error(ILLEGAL_WORD, (L"'" + lexer.GetStrToken() + L"'").c_str(),
                               lexer.GetPreWordRow(), lexer.GetPreWordCol(), lexer.GetRowPos(), lexer.GetColPos());
@@ -1558,11 +2121,26 @@ void Parser::prog()
 
 /**
  * @brief 启动语法分析
- * @details 入口函数，调用prog()开始分析并输出结果
+ * @details 入口函数，调用prog()开始分析并输出结果；
+ *          整体词法分析模式下先得到连续的词法单元序列，语法分析按序消费；
+ *          流水线模式下词法分析在独立线程上进行，经环形队列按批供给；
+ *          语法树模式下先建立整个程序的语法树，分析结束后一次降级生成P-Code，
+ *          语法树保留到下次编译开始时随分配区整体释放
  */
 void Parser::analyze()
 {
+    astArena.Reset();
+    astRoot = nullptr;
+    procTail = &astRoot;
+    bool started = pipelined && lexer.StartPipeline();
+    if (!started && tokenizeAll) {
+        lexer.Tokenize(tokenizeThreads);
+    }
     lexer.GetWord();
     prog();
+    lexer.StopPipeline();
+    if (buildAst) {
+        LowerAst(astRoot, pcodelist);
+    }
     errorHandle.over();
 }
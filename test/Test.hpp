@@ -0,0 +1,114 @@
+/**
+ * @file Test.hpp
+ * @brief 自动化测试框架
+ * @details 各测试文件以TEST定义测试用例，CHECK断言不成立时记录位置并使该用例失败；
+ *          TestMain.cpp依次运行全部用例，有失败时以非零退出码结束。
+ *          测试从仓库根目录运行，示例程序与临时生成的源文件都在test目录下
+ */
+
+#ifndef _TEST_HPP
+#define _TEST_HPP
+
+#include <Compiler.hpp>
+#include <Benchmark.hpp>
+#include <functional>
+using namespace std;
+
+// 示例程序与临时文件目录
+const string TEST_DIR = "test/";
+
+/**
+ * @struct TestCase
+ * @brief 一个已注册的测试用例
+ */
+struct TestCase
+{
+    const char* name;         // 用例名
+    void (*body)();           // 用例函数
+};
+
+vector<TestCase>& TestRegistry();                               // 全部已注册的用例
+void TestFail(const char* file, int line, const char* expr);    // 记录一次断言失败
+
+/**
+ * @struct TestRegistrar
+ * @brief 静态初始化时把用例加入注册表
+ */
+struct TestRegistrar
+{
+    TestRegistrar(const char* name, void (*body)()) { TestRegistry().push_back({ name, body }); }
+};
+
+// 定义测试用例
+#define TEST(name) \
+    static void Test_##name(); \
+    static TestRegistrar registrar_##name(#name, Test_##name); \
+    static void Test_##name()
+
+// 断言，不成立时记录失败并继续执行本用例
+#define CHECK(cond) do { if (!(cond)) TestFail(__FILE__, __LINE__, #cond); } while (0)
+
+/**
+ * @class TempSource
+ * @brief 作用域内存在的临时源文件
+ * @details 析构时删除文件；Windows下仍被映射的文件无法删除，
+ *          因此应先于打开它的编译上下文声明
+ */
+class TempSource
+{
+private:
+    string path;              // 文件路径
+
+public:
+    explicit TempSource(const string& name) : path(TEST_DIR + "tmp_" + name + ".txt") {}
+    ~TempSource() { remove(path.c_str()); }
+    TempSource(const TempSource&) = delete;
+    TempSource& operator=(const TempSource&) = delete;
+
+    const string& Path() const { return path; }
+};
+
+/**
+ * @struct Compiled
+ * @brief 一次编译的可比较结果
+ */
+struct Compiled
+{
+    bool opened = false;      // 文件是否打开成功
+    unsigned errors = 0;      // 错误数
+    size_t lines = 0;         // 源程序行数
+    vector<PCode> code;       // 生成的P-Code
+    wstring diagnostics;      // 全部诊断输出
+};
+
+/**
+ * @struct Lexed
+ * @brief 一次完整词法分析的可比较结果
+ */
+struct Lexed
+{
+    vector<unsigned long> types;    // 各词法单元类型
+    vector<wstring> texts;          // 各词法单元字符串
+    vector<size_t> rows, cols;      // 各词法单元结束处的行列号
+    wstring diagnostics;            // 全部诊断输出
+
+    bool operator==(const Lexed& other) const
+    {
+        return types == other.types && texts == other.texts && rows == other.rows
+            && cols == other.cols && diagnostics == other.diagnostics;
+    }
+};
+
+typedef function<void(CompilerContext&)> Configure;    // 打开源文件之前设置上下文的各项模式
+
+wostream& Discard();    // 丢弃写入内容的输出流(每线程一个)
+void Quiet(CompilerContext& context, wostream& diagnostics = Discard());    // 诊断写入指定流，读取过程信息丢弃
+Compiled CompileFile(const string& filename, const Configure& configure = nullptr);    // 以给定模式编译
+Lexed LexFile(const string& filename, const Configure& configure = nullptr);          // 以给定模式词法分析
+void CollectTokens(Lexer& lexer, Lexed& result);                       // 词法分析已打开的源程序直到结束
+wstring RunProgram(CompilerContext& context, const wstring& input);    // 运行已编译的程序并取回输出
+bool SameCode(const vector<PCode>& a, const vector<PCode>& b);        // 两段P-Code是否逐条相同
+vector<string> SamplePrograms();     // test目录下全部示例程序(含有错误的)
+vector<string> RunnablePrograms();    // test目录下可以运行的示例程序
+
+#endif
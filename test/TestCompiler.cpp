@@ -0,0 +1,92 @@
+/**
+ * @file TestCompiler.cpp
+ * @brief 编译上下文与批量编译测试
+ * @details 同一源程序无论由哪个上下文、以多少线程编译，结果都应相同
+ */
+
+#include "Test.hpp"
+#include <Batch.hpp>
+
+/**
+ * @brief 每线程一个上下文并发编译与顺序编译一致
+ * @details 各程序长短不同，部分含错误；比较P-Code与诊断输出
+ */
+TEST(ConcurrentContexts)
+{
+    const unsigned programs = 8;
+    deque<TempSource> sources;
+    for (unsigned i = 0; i < programs; i++) {
+        sources.emplace_back("context_" + to_string(i));
+        GenerateSource(sources.back().Path(), 20000 + i * 1000, false, i % 2 == 0 ? 0 : 100);
+    }
+
+    vector<Compiled> expected, actual(programs);
+    for (unsigned i = 0; i < programs; i++) {
+        expected.push_back(CompileFile(sources[i].Path()));
+    }
+    vector<thread> workers;
+    for (unsigned i = 0; i < programs; i++) {
+        workers.emplace_back([&, i]() { actual[i] = CompileFile(sources[i].Path()); });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    for (unsigned i = 0; i < programs; i++) {
+        CHECK(expected[i].opened && actual[i].opened);
+        CHECK(expected[i].errors == actual[i].errors);
+        CHECK(expected[i].diagnostics == actual[i].diagnostics);
+        CHECK(SameCode(expected[i].code, actual[i].code));
+    }
+}
+
+/**
+ * @brief 批量编译结果与线程数无关
+ * @details 含错误与不存在的文件；各文件的行数、P-Code条数、错误数、诊断与运行输出都应一致，
+ *          并且与单独编译该文件的结果相同
+ */
+TEST(BatchThreadCounts)
+{
+    const size_t programs = 200;
+    deque<TempSource> sources;
+    vector<string> files;
+    for (size_t i = 0; i < programs; i++) {
+        sources.emplace_back("batch_" + to_string(i));
+        GenerateSource(sources.back().Path(), 20 + (i * 7919) % 500, false, i % 10 == 0 ? 50 : 0);
+        files.push_back(sources.back().Path());
+    }
+    files.push_back(TEST_DIR + "tmp_missing.txt");
+    files.push_back(TEST_DIR + "factorial.txt");
+
+    vector<BatchResult> expected;
+    const unsigned threadCounts[] = { 1, 2, 4, 8 };
+    for (unsigned threads : threadCounts) {
+        BatchOptions options;
+        options.threads = threads;
+        options.run = true;
+        vector<BatchResult> results;
+        BatchStats stats = CompileBatch(files, options, results);
+        CHECK(stats.files == files.size());
+        CHECK(results.size() == files.size());
+        if (threads == 1) {
+            expected = results;
+            continue;
+        }
+        for (size_t i = 0; i < results.size() && i < expected.size(); i++) {
+            CHECK(results[i].filename == expected[i].filename);
+            CHECK(results[i].opened == expected[i].opened);
+            CHECK(results[i].lines == expected[i].lines);
+            CHECK(results[i].codes == expected[i].codes);
+            CHECK(results[i].errors == expected[i].errors);
+            CHECK(results[i].diagnostics == expected[i].diagnostics);
+            CHECK(results[i].output == expected[i].output);
+        }
+    }
+
+    CHECK(!expected[programs].opened);
+    for (size_t i = 0; i < programs; i += 17) {
+        Compiled single = CompileFile(files[i]);
+        CHECK(expected[i].errors == single.errors);
+        CHECK(expected[i].codes == single.code.size());
+    }
+}
@@ -0,0 +1,157 @@
+/**
+ * @file TestInterpreter.cpp
+ * @brief 优化与解释执行测试
+ * @details 各种优化与执行方式都不应改变程序输出
+ */
+
+#include "Test.hpp"
+
+// 示例程序的输入，读语句依次读入10
+static const wstring SAMPLE_INPUT = L"10 10 10 10";
+
+/**
+ * @brief 窥孔优化不改变程序输出且不增加指令
+ */
+TEST(PeepholeKeepsOutput)
+{
+    for (const string& file : RunnablePrograms()) {
+        CompilerContext context;
+        Quiet(context);
+        CHECK(context.Compile(file));
+        wstring expected = RunProgram(context, SAMPLE_INPUT);
+        PeepholeStats stats = context.Optimize();
+        CHECK(stats.after <= stats.before);
+        CHECK(stats.after == context.pcodelist.code_list.size());
+        CHECK(RunProgram(context, SAMPLE_INPUT) == expected);
+    }
+}
+
+/**
+ * @brief 超级指令不改变程序输出
+ * @details 合并后的分派次数应少于只做窥孔优化时
+ */
+TEST(SuperinstructionsKeepOutput)
+{
+    for (const string& file : RunnablePrograms()) {
+        CompilerContext context;
+        Quiet(context);
+        CHECK(context.Compile(file));
+        wstring expected = RunProgram(context, SAMPLE_INPUT);
+
+        context.Optimize();
+        CHECK(RunProgram(context, SAMPLE_INPUT) == expected);
+        size_t optimized = context.interpreter.dispatched;
+
+        PeepholeStats stats = context.Fuse();
+        CHECK(RunProgram(context, SAMPLE_INPUT) == expected);
+        if (stats.after < stats.before) {
+            CHECK(context.interpreter.dispatched < optimized);
+        }
+    }
+}
+
+/**
+ * @brief 直接线索化执行与逐条解释一致
+ * @details 原始指令与超级指令上分别比较，程序输出与分派次数都应相同
+ */
+TEST(ThreadedDispatch)
+{
+    TempSource generated("loop");
+    GenerateLoopSource(generated.Path(), 20);
+    vector<string> files = RunnablePrograms();
+    files.push_back(generated.Path());
+
+    for (const string& file : files) {
+        for (int fused = 0; fused < 2; fused++) {
+            CompilerContext context;
+            Quiet(context);
+            CHECK(context.Compile(file));
+            if (fused) {
+                context.Optimize();
+                context.Fuse();
+            }
+            context.interpreter.SetThreaded(false);
+            wstring expected = RunProgram(context, SAMPLE_INPUT);
+            size_t dispatched = context.interpreter.dispatched;
+            context.interpreter.SetThreaded(true);
+            CHECK(RunProgram(context, SAMPLE_INPUT) == expected);
+            CHECK(context.interpreter.dispatched == dispatched);
+        }
+    }
+}
+
+/**
+ * @brief 固定容量运行时栈
+ * @details 各种分配方式的输出与按需扩展的栈一致，保护页模式的容量不小于请求；
+ *          过小的栈应报告溢出而不是越界
+ */
+TEST(FixedStack)
+{
+    struct Mode { unsigned flags; bool fixed; };
+    const Mode modes[] = { { 0, false }, { 0, true }, { STACK_GUARD, true }, { STACK_HUGE_PAGES, true } };
+    const size_t cells = 4 * VM_STACK_DEFAULT;
+    const wstring input = L"1000";
+
+    for (const string& file : RunnablePrograms()) {
+        CompilerContext context;
+        Quiet(context);
+        CHECK(context.Compile(file));
+        context.interpreter.SetThreaded(true);
+        wstring expected;
+        for (const Mode& mode : modes) {
+            context.interpreter.SetFixedStack(mode.fixed ? cells : 0, mode.flags);
+            wstring actual = RunProgram(context, input);
+            CHECK(!context.interpreter.stackOverflow);
+            if (!mode.fixed) {
+                expected = actual;
+                continue;
+            }
+            CHECK(context.interpreter.GetFixedStack().Capacity() >= cells);
+            CHECK(actual == expected);
+        }
+        context.interpreter.SetFixedStack(0);
+    }
+
+    const bool threadedModes[] = { false, true };
+    for (bool threaded : threadedModes) {
+        CompilerContext context;
+        Quiet(context);
+        CHECK(context.Compile(TEST_DIR + "recursive-factorial.txt"));
+        context.interpreter.SetThreaded(threaded);
+        context.interpreter.SetFixedStack(1000, STACK_GUARD);
+        RunProgram(context, L"10000");
+        CHECK(context.interpreter.stackOverflow);
+        context.interpreter.SetFixedStack(0);
+    }
+}
+
+/**
+ * @brief 栈深度分析
+ * @details 非递归程序按分析得到的容量分配固定栈即可运行且输出不变；
+ *          递归程序无法确定上界
+ */
+TEST(FrameAnalysis)
+{
+    TempSource generated("frames");
+    GenerateLoopSource(generated.Path(), 20);
+    const string files[] = { generated.Path(), TEST_DIR + "fibonacci.txt", TEST_DIR + "factorial.txt" };
+
+    for (const string& file : files) {
+        CompilerContext context;
+        Quiet(context);
+        CHECK(context.Compile(file));
+        size_t bound = context.pcodelist.stackBound;
+        CHECK(bound > 0);
+        wstring expected = RunProgram(context, SAMPLE_INPUT);
+        context.interpreter.SetThreaded(true);
+        context.interpreter.SetFixedStack(bound);
+        CHECK(RunProgram(context, SAMPLE_INPUT) == expected);
+        CHECK(!context.interpreter.stackOverflow);
+        context.interpreter.SetFixedStack(0);
+    }
+
+    CompilerContext context;
+    Quiet(context);
+    CHECK(context.Compile(TEST_DIR + "recursive-factorial.txt"));
+    CHECK(context.pcodelist.stackBound == 0);
+}
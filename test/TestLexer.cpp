@@ -0,0 +1,201 @@
+/**
+ * @file TestLexer.cpp
+ * @brief 词法分析测试
+ * @details 各种词法分析方式对同一源程序应得到相同的词法单元序列、诊断与P-Code
+ */
+
+#include "Test.hpp"
+
+/**
+ * @brief 保留字查找与逐项比较(LinearKeyword)一致
+ * @details 全部保留字、保留字的前缀与变形、随机生成的标识符
+ */
+TEST(KeywordLookup)
+{
+    static const wchar_t* words[RSV_WORD_MAX] = {
+        L"odd", L"begin", L"end", L"if", L"then", L"while", L"do", L"call",
+        L"const", L"var", L"procedure", L"write", L"read", L"program", L"else"
+    };
+    vector<wstring> samples;
+    for (const wchar_t* word : words) {
+        wstring keyword(word);
+        CHECK(LinearKeyword(keyword) != IDENT);
+        samples.push_back(keyword);
+        samples.push_back(keyword.substr(0, keyword.length() - 1));
+        samples.push_back(keyword + L"s");
+        samples.push_back(L"x" + keyword.substr(1));
+    }
+    unsigned int seed = 12345;
+    for (int i = 0; i < 20000; i++) {
+        wstring word;
+        seed = seed * 1103515245 + 12345;
+        size_t length = 1 + (seed >> 12) % 10;
+        for (size_t j = 0; j < length; j++) {
+            seed = seed * 1103515245 + 12345;
+            word += static_cast<wchar_t>(L'a' + (seed >> 8) % 26);
+        }
+        samples.push_back(word);
+    }
+
+    for (const wstring& word : samples) {
+        CHECK(LookupKeyword(word.data(), word.length()) == LinearKeyword(word));
+    }
+}
+
+/**
+ * @brief 原子表
+ * @details 同名得到同一原子，不同名得到不同原子，宽字符与UTF-8名称共用原子且可取回
+ */
+TEST(AtomInterning)
+{
+    AtomTable table;
+    Atom counter = table.Intern(L"counter");
+    CHECK(table.Intern(wstring(L"counter")) == counter);
+    CHECK(table.Intern(L"count") != counter);
+    CHECK(table.InternUtf8("counter", 7) == counter);
+    CHECK(table.Name(counter) == L"counter");
+
+    Atom wide = table.Intern(L"\x53d8\x91cf");
+    CHECK(table.InternUtf8("\xE5\x8F\x98\xE9\x87\x8F", 6) == wide);
+    CHECK(table.NameUtf8(wide) == "\xE5\x8F\x98\xE9\x87\x8F");
+
+    // 扩容后原子保持不变
+    vector<Atom> atoms;
+    for (int i = 0; i < 5000; i++) {
+        atoms.push_back(table.Intern(L"symbol" + to_wstring(i)));
+    }
+    for (int i = 0; i < 5000; i++) {
+        CHECK(table.Intern(L"symbol" + to_wstring(i)) == atoms[i]);
+    }
+    CHECK(table.Size() == 3 + 5000);
+    CHECK(table.Intern(L"counter") == counter);
+}
+
+/**
+ * @brief 诊断的源码片段取自出错的行
+ * @details 每10行插入一条错误语句；每个错误都报告在正确的行上并附带该行的源码，
+ *          LF文件经直接访问、CRLF文件经解码后的分块存储取行
+ */
+TEST(DiagnosticSnippets)
+{
+    const size_t lines = 2000;
+    const size_t header = 5;    // GenerateSource生成的程序头行数
+    const bool crlfModes[] = { false, true };
+    for (bool crlf : crlfModes) {
+        TempSource source(crlf ? "diag_crlf" : "diag_lf");
+        GenerateSource(source.Path(), lines, crlf, 10);
+        Compiled result = CompileFile(source.Path());
+        CHECK(result.errors == lines / 10);
+        wstring text = L"\n" + result.diagnostics;    // 每条诊断都从行首开始
+        for (size_t row = header + 10; row <= header + lines; row += 10) {
+            wstring location = L"\n" + to_wstring(row) + L":7: error";
+            wstring snippet = to_wstring(row) + L" |     a = a + 1;\n";
+            CHECK(text.find(location) != wstring::npos);
+            CHECK(text.find(snippet) != wstring::npos);
+        }
+    }
+}
+
+/**
+ * @brief 逐字符分支与DFA两种扫描方式一致
+ * @details 词法单元序列、行列号、诊断与生成的P-Code都应相同
+ */
+TEST(ScanModesAgree)
+{
+    TempSource generated("scan_modes");
+    GenerateSource(generated.Path(), 5000, false, 50);
+    vector<string> files = SamplePrograms();
+    files.push_back(generated.Path());
+
+    auto classic = [](CompilerContext& context) { context.lexer.SetScanMode(SCAN_CLASSIC); };
+    auto dfa = [](CompilerContext& context) { context.lexer.SetScanMode(SCAN_DFA); };
+    for (const string& file : files) {
+        CHECK(LexFile(file, classic) == LexFile(file, dfa));
+        Compiled a = CompileFile(file, classic), b = CompileFile(file, dfa);
+        CHECK(a.errors == b.errors);
+        CHECK(a.diagnostics == b.diagnostics);
+        CHECK(SameCode(a.code, b.code));
+    }
+}
+
+/**
+ * @brief 先整体词法分析再回放与边扫描边分析一致
+ * @details 词法错误回放到所属词法单元时才报告，诊断顺序不变
+ */
+TEST(TokenizeAllAgrees)
+{
+    TempSource generated("tokenize_all");
+    GenerateSource(generated.Path(), 5000, false, 50);
+    vector<string> files = SamplePrograms();
+    files.push_back(generated.Path());
+
+    for (const string& file : files) {
+        Compiled streaming = CompileFile(file);
+        Compiled tokenized = CompileFile(file, [](CompilerContext& context) { context.parser.SetTokenizeAll(true); });
+        CHECK(streaming.errors == tokenized.errors);
+        CHECK(streaming.diagnostics == tokenized.diagnostics);
+        CHECK(SameCode(streaming.code, tokenized.code));
+    }
+}
+
+/**
+ * @brief 多线程词法分析与单线程逐项相同
+ * @details 源程序大于两块的最小长度才会切分；比较词法单元的全部字段
+ */
+TEST(ParallelTokenize)
+{
+    TempSource source("parallel");
+    GenerateSource(source.Path(), 120000);
+
+    vector<Token> expected;
+    const unsigned threadCounts[] = { 1, 2, 3, 4, 8 };
+    for (unsigned threads : threadCounts) {
+        CompilerContext context;
+        Quiet(context);
+        CHECK(context.Open(source.Path()));
+        context.lexer.Tokenize(threads);
+        const vector<Token>& tokens = context.lexer.GetTokens();
+        if (threads == 1) {
+            expected = tokens;
+            CHECK(!expected.empty());
+            continue;
+        }
+        bool same = tokens.size() == expected.size();
+        for (size_t i = 0; same && i < tokens.size(); i++) {
+            const Token& a = tokens[i];
+            const Token& b = expected[i];
+            same = a.type == b.type && a.offset == b.offset && a.length == b.length && a.row == b.row
+                && a.col == b.col && a.preRow == b.preRow && a.preCol == b.preCol && a.atom == b.atom && a.ch == b.ch;
+        }
+        CHECK(same);
+    }
+}
+
+/**
+ * @brief 一千万个空行
+ * @details 换行以循环跳过而非递归，两种扫描方式、LF与CRLF文件都应在常数栈深度内完成，
+ *          不报错，行数正确，生成的P-Code相同
+ */
+TEST(BlankLines)
+{
+    const size_t blankLines = 10000000;
+    const bool crlfModes[] = { false, true };
+    const ScanMode modes[] = { SCAN_CLASSIC, SCAN_DFA };
+    for (bool crlf : crlfModes) {
+        TempSource source(crlf ? "blank_crlf" : "blank_lf");
+        GenerateBlankSource(source.Path(), blankLines, crlf);
+        Compiled expected;
+        for (ScanMode mode : modes) {
+            Compiled result = CompileFile(source.Path(), [mode](CompilerContext& context) { context.lexer.SetScanMode(mode); });
+            CHECK(result.opened);
+            CHECK(result.errors == 0);
+            CHECK(result.lines == blankLines + 6);    // 另有5行程序与文件末尾换行后的空行
+            CHECK(!result.code.empty());
+            if (mode == SCAN_CLASSIC) {
+                expected = result;
+                continue;
+            }
+            CHECK(SameCode(result.code, expected.code));
+        }
+    }
+}
@@ -0,0 +1,207 @@
+/**
+ * @file TestMain.cpp
+ * @brief 自动化测试入口与共用辅助函数
+ * @details 依次运行全部已注册的用例，逐个输出结果；有失败时退出码为1
+ */
+
+#include "Test.hpp"
+
+static vector<string> failures;   // 当前用例不成立的断言
+
+/**
+ * @brief 获取全部已注册的用例
+ */
+vector<TestCase>& TestRegistry()
+{
+    static vector<TestCase> registry;
+    return registry;
+}
+
+/**
+ * @brief 记录一次断言失败
+ * @param file 断言所在文件
+ * @param line 断言所在行
+ * @param expr 不成立的表达式
+ */
+void TestFail(const char* file, int line, const char* expr)
+{
+    failures.push_back(string(file) + ":" + to_string(line) + ": CHECK(" + expr + ")");
+}
+
+/**
+ * @brief 获取丢弃写入内容的输出流
+ * @details 无缓冲区的流，写入被忽略；每线程一个，并发编译时互不影响
+ */
+wostream& Discard()
+{
+    thread_local wostream discard(nullptr);
+    return discard;
+}
+
+/**
+ * @brief 诊断写入指定流，读取过程信息丢弃
+ * @param context 编译上下文
+ * @param diagnostics 诊断输出流，默认丢弃
+ */
+void Quiet(CompilerContext& context, wostream& diagnostics)
+{
+    context.readUnicode.SetLog(Discard());
+    context.errorHandle.SetOutput(diagnostics);
+}
+
+/**
+ * @brief 以给定模式编译源文件
+ * @param filename 源文件路径
+ * @param configure 打开源文件之前设置上下文的各项模式，可为空
+ * @return 编译结果
+ */
+Compiled CompileFile(const string& filename, const Configure& configure)
+{
+    Compiled result;
+    wostringstream diagnostics;
+    {
+        CompilerContext context;
+        Quiet(context, diagnostics);
+        if (configure) {
+            configure(context);
+        }
+        result.opened = context.Open(filename);
+        if (result.opened) {
+            context.Compile();
+            result.errors = context.errorHandle.GetErrorCount();
+            result.lines = context.lexer.GetLineCount();
+            result.code = context.pcodelist.code_list;
+        }
+    }
+    result.diagnostics = diagnostics.str();
+    return result;
+}
+
+/**
+ * @brief 以给定模式完整词法分析源文件
+ * @param filename 源文件路径
+ * @param configure 打开源文件之前设置上下文的各项模式，可为空
+ * @return 词法单元序列与诊断
+ */
+Lexed LexFile(const string& filename, const Configure& configure)
+{
+    Lexed result;
+    wostringstream diagnostics;
+    {
+        CompilerContext context;
+        Quiet(context, diagnostics);
+        if (configure) {
+            configure(context);
+        }
+        context.Open(filename);
+        CollectTokens(context.lexer, result);
+    }
+    result.diagnostics = diagnostics.str();
+    return result;
+}
+
+/**
+ * @brief 词法分析已打开的源程序直到结束
+ * @param lexer 词法分析器
+ * @param result 追加各词法单元的类型、字符串与行列号
+ */
+void CollectTokens(Lexer& lexer, Lexed& result)
+{
+    lexer.GetWord();
+    while (lexer.GetCh() != L'\0') {
+        result.types.push_back(lexer.GetTokenType());
+        result.texts.push_back(lexer.GetStrToken());
+        result.rows.push_back(lexer.GetRowPos());
+        result.cols.push_back(lexer.GetColPos());
+        lexer.GetWord();
+    }
+}
+
+/**
+ * @brief 运行已编译的程序并取回输出
+ * @param context 编译上下文
+ * @param input 程序输入
+ * @return 程序输出
+ */
+wstring RunProgram(CompilerContext& context, const wstring& input)
+{
+    wistringstream in(input);
+    wostringstream out;
+    context.interpreter.SetIO(in, out);
+    context.Run();
+    context.interpreter.SetIO(wcin, wcout);
+    return out.str();
+}
+
+/**
+ * @brief 比较两段P-Code是否逐条相同
+ */
+bool SameCode(const vector<PCode>& a, const vector<PCode>& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].op != b[i].op || a[i].L != b[i].L || a[i].a != b[i].a || a[i].b != b[i].b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief test目录下全部示例程序(含有错误的)
+ */
+vector<string> SamplePrograms()
+{
+    static const char* names[] = {
+        "lexer1.txt", "lexer2.txt", "lexer3.txt", "lexer4.txt",
+        "parser1.txt", "parser2.txt", "parser3.txt", "parser4.txt", "parser5.txt", "parser6.txt", "parser7.txt",
+        "test1.txt", "test2.txt", "symbol.txt", "pcode.txt",
+        "factorial.txt", "fibonacci.txt", "z=x+y.txt", "recursive-factorial.txt",
+    };
+    vector<string> files;
+    for (const char* name : names) {
+        files.push_back(TEST_DIR + name);
+    }
+    return files;
+}
+
+/**
+ * @brief test目录下可以运行的示例程序
+ */
+vector<string> RunnablePrograms()
+{
+    static const char* names[] = {
+        "factorial.txt", "fibonacci.txt", "recursive-factorial.txt", "z=x+y.txt", "pcode.txt",
+    };
+    vector<string> files;
+    for (const char* name : names) {
+        files.push_back(TEST_DIR + name);
+    }
+    return files;
+}
+
+/**
+ * @brief 测试程序入口
+ * @return 全部通过返回0，否则返回1
+ */
+int main()
+{
+    _setmode(_fileno(stdout), _O_U16TEXT);
+
+    size_t failed = 0;
+    for (const TestCase& test : TestRegistry()) {
+        failures.clear();
+        test.body();
+        wcout << (failures.empty() ? L"[PASS] " : L"[FAIL] ") << test.name << endl;
+        for (const string& failure : failures) {
+            wcout << L"    " << failure.c_str() << endl;
+        }
+        if (!failures.empty()) {
+            failed++;
+        }
+    }
+    wcout << TestRegistry().size() << L" 个用例, " << failed << L" 个失败" << endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file TestParser.cpp
+ * @brief 语法分析测试
+ * @details 各种语法分析与代码生成方式不应改变生成的P-Code与诊断，常量折叠不应改变程序输出
+ */
+
+#include "Test.hpp"
+
+/**
+ * @brief 词法/语法分析流水线与单线程一致
+ * @details 生成的P-Code逐条相同；词法错误与语法错误交错出现时，
+ *          流水线模式下词法分析线程发现的错误仍按所属词法单元的顺序报告，诊断输出与单线程相同
+ */
+TEST(PipelineAgrees)
+{
+    TempSource clean("pipeline"), faulty("pipeline_errors");
+    GenerateSource(clean.Path(), 200000);
+    {
+        ofstream out(faulty.Path(), ios::binary);
+        out << "program faulty;\nvar a, b;\nbegin\n    a := 0;\n";
+        for (int i = 0; i < 20000; i++) {
+            if (i % 7 == 3) {
+                out << "    @a := a + 1;\n";       // 非法字符
+            }
+            else if (i % 11 == 5) {
+                out << "    a = a + 1;\n";         // 误用'='赋值
+            }
+            else if (i % 13 == 0) {
+                out << "    @b = a;\n";            // 非法字符后又误用'='
+            }
+            else {
+                out << "    b := a * 2 - b;\n";
+            }
+        }
+        out << "    a := b\nend\n";
+    }
+
+    auto pipelined = [](CompilerContext& context) { context.parser.SetPipelined(true); };
+    const string files[] = { clean.Path(), faulty.Path() };
+    for (const string& file : files) {
+        Compiled a = CompileFile(file);
+        Compiled b = CompileFile(file, pipelined);
+        CHECK(!a.code.empty());
+        CHECK(a.errors == b.errors);
+        CHECK(a.diagnostics == b.diagnostics);
+        CHECK(SameCode(a.code, b.code));
+    }
+    CHECK(CompileFile(faulty.Path()).errors > 1000);    // 错误遍布各批词法单元
+}
+
+/**
+ * @brief 经语法树降级与直接生成的P-Code逐条相同
+ * @details 示例程序中含有错误的也要比较，错误恢复后的生成结果同样应一致
+ */
+TEST(AstLoweringAgrees)
+{
+    TempSource generated("ast");
+    GenerateSource(generated.Path(), 20000, false, 100);
+    vector<string> files = SamplePrograms();
+    files.push_back(generated.Path());
+
+    for (const string& file : files) {
+        Compiled direct = CompileFile(file);
+        Compiled lowered = CompileFile(file, [](CompilerContext& context) { context.parser.SetBuildAst(true); });
+        CHECK(direct.errors == lowered.errors);
+        CHECK(direct.diagnostics == lowered.diagnostics);
+        CHECK(SameCode(direct.code, lowered.code));
+    }
+}
+
+/**
+ * @brief 深度嵌套表达式
+ * @details 浅嵌套时递归下降与显式栈一致；一百万层嵌套只用显式栈分析，
+ *          直接生成与语法树模式一致且不报错
+ */
+TEST(NestedExpressions)
+{
+    TempSource source("nested");
+    auto recursive = [](CompilerContext& context) { context.parser.SetRecursiveExp(true); };
+    auto explicitStack = [](CompilerContext& context) { context.parser.SetRecursiveExp(false); };
+    auto lowered = [](CompilerContext& context) {
+        context.parser.SetRecursiveExp(false);
+        context.parser.SetBuildAst(true);
+    };
+
+    GenerateNestedSource(source.Path(), 1000);
+    Compiled a = CompileFile(source.Path(), recursive);
+    Compiled b = CompileFile(source.Path(), explicitStack);
+    CHECK(a.errors == 0);
+    CHECK(SameCode(a.code, b.code));
+
+    GenerateNestedSource(source.Path(), 1000000);
+    Compiled deep = CompileFile(source.Path(), explicitStack);
+    Compiled deepAst = CompileFile(source.Path(), lowered);
+    CHECK(deep.errors == 0);
+    CHECK(!deep.code.empty());
+    CHECK(SameCode(deep.code, deepAst.code));
+}
+
+/**
+ * @brief 逐层查找与名称索引查找一致
+ * @details 大量变量的生成程序与含嵌套过程、同名遮蔽的示例程序
+ */
+TEST(SymbolLookupModes)
+{
+    TempSource generated("lookup");
+    GenerateSymbolSource(generated.Path(), 5000);
+    vector<string> files = SamplePrograms();
+    files.push_back(generated.Path());
+
+    auto chain = [](CompilerContext& context) { context.symTable.SetIndexed(false); };
+    auto index = [](CompilerContext& context) { context.symTable.SetIndexed(true); };
+    for (const string& file : files) {
+        Compiled a = CompileFile(file, chain), b = CompileFile(file, index);
+        CHECK(a.errors == b.errors);
+        CHECK(a.diagnostics == b.diagnostics);
+        CHECK(SameCode(a.code, b.code));
+    }
+}
+
+/**
+ * @brief 重复编译时符号信息存储不增长
+ * @details 同一上下文反复编译同一程序，符号表的堆内存占用各轮保持不变
+ */
+TEST(SymbolStoreReuse)
+{
+    TempSource source("symstore");
+    GenerateSymbolSource(source.Path(), 20000);
+
+    CompilerContext context;
+    Quiet(context);
+    size_t first = 0;
+    for (int round = 0; round < 5; round++) {
+        CHECK(context.Compile(source.Path()));
+        size_t bytes = context.symTable.GetMemoryBytes();
+        if (round == 0) {
+            first = bytes;
+        }
+        CHECK(bytes == first);
+    }
+}
+
+/**
+ * @brief 常量折叠不改变程序输出
+ * @details 示例程序很少含常量表达式，生成的常量密集程序折叠后指令应明显减少
+ */
+TEST(FoldKeepsOutput)
+{
+    TempSource generated("fold");
+    GenerateConstantSource(generated.Path(), 16);
+    vector<string> files = RunnablePrograms();
+    files.push_back(generated.Path());
+
+    for (const string& file : files) {
+        CompilerContext context;
+        Quiet(context);
+        CHECK(context.Compile(file));
+        size_t before = context.pcodelist.code_list.size();
+        wstring expected = RunProgram(context, L"10 10 10 10");
+
+        context.parser.SetFoldConstants(true);
+        CHECK(context.Compile(file));
+        size_t after = context.pcodelist.code_list.size();
+        CHECK(RunProgram(context, L"10 10 10 10") == expected);
+        CHECK(after <= before);
+        if (file == generated.Path()) {
+            CHECK(after < before);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * @file TestReader.cpp
+ * @brief 源文件读取测试
+ * @details 不同的读取后端与存储方式对同一源程序应得到相同的词法单元序列与诊断
+ */
+
+#include "Test.hpp"
+
+/**
+ * @brief 以指定后端与回看窗口完整词法分析
+ * @param filename 源文件路径
+ * @param backend 读取后端
+ * @param retention 回看窗口字符数
+ * @param retained 输出词法分析结束时分块存储占用的字节数
+ */
+static Lexed LexWith(const string& filename, SourceBackend backend, size_t retention = RETAIN_ALL,
+                     size_t* retained = nullptr)
+{
+    Lexed result;
+    wostringstream diagnostics;
+    {
+        CompilerContext context;
+        Quiet(context, diagnostics);
+        context.Reset();
+        context.readUnicode.SetRetention(retention);
+        context.readUnicode.readFile2USC2(filename, backend);
+        CollectTokens(context.lexer, result);
+        if (retained) {
+            *retained = context.readUnicode.GetRetainedBytes();
+        }
+    }
+    result.diagnostics = diagnostics.str();
+    return result;
+}
+
+/**
+ * @brief 流式与映射后端结果一致
+ * @details 覆盖可直接访问的LF文件、需要解码的CRLF文件与含中文字符、非法字符的示例程序
+ */
+TEST(ReaderBackendsAgree)
+{
+    TempSource lf("reader_lf"), crlf("reader_crlf");
+    GenerateSource(lf.Path(), 20000);
+    GenerateSource(crlf.Path(), 20000, true);
+
+    const string files[] = { lf.Path(), crlf.Path(), TEST_DIR + "lexer4.txt", TEST_DIR + "lexer2.txt" };
+    for (const string& file : files) {
+        Lexed stream = LexWith(file, BACKEND_STREAM);
+        Lexed mapping = LexWith(file, BACKEND_MAPPING);
+        CHECK(!stream.types.empty());
+        CHECK(stream == mapping);
+    }
+}
+
+/**
+ * @brief 直接访问模式下getProgmWStr按字节返回
+ * @details 含多字节字符的UTF-8文件逐字节对应映射内存，逐个解码后与流式后端的字符一致
+ */
+TEST(DirectModeIsByteAddressed)
+{
+    TempSource utf8("reader_utf8");
+    {
+        ofstream out(utf8.Path(), ios::binary);
+        out << "program p;\nvar a;\nbegin\n    a := 1 \xE6\xB5\x8B\nend\n";
+    }
+    CompilerContext mapped, streamed;
+    Quiet(mapped);
+    Quiet(streamed);
+    mapped.Reset();
+    streamed.Reset();
+    mapped.readUnicode.readFile2USC2(utf8.Path(), BACKEND_MAPPING);
+    streamed.readUnicode.readFile2USC2(utf8.Path(), BACKEND_STREAM);
+
+    const unsigned char* data = mapped.readUnicode.GetDirectData();
+    CHECK(data != nullptr);
+    if (data == nullptr) {
+        return;
+    }
+    size_t length = mapped.readUnicode.GetDirectLength();
+    size_t chars = 0;
+    for (size_t pos = 0; pos < length; chars++) {
+        CHECK(mapped.readUnicode.getProgmWStr(pos) == data[pos]);
+        size_t bytes = 1;
+        wchar_t ch = data[pos] < 0x80 ? data[pos] : DecodeUtf8(data + pos, bytes);
+        CHECK(ch == streamed.readUnicode.getProgmWStr(chars));
+        pos += bytes;
+    }
+    CHECK(chars + 2 == length);
+    CHECK(mapped.readUnicode.getProgmWStr(length) == L'#');
+}
+
+/**
+ * @brief 回看窗口不改变词法分析结果
+ * @details 流式后端下只保留一块时识别的词法单元与全部保留相同，存储占用更小
+ */
+TEST(SourceStoreWindow)
+{
+    TempSource source("reader_store");
+    GenerateSource(source.Path(), 50000);
+
+    size_t full = 0, window = 0;
+    Lexed all = LexWith(source.Path(), BACKEND_STREAM, RETAIN_ALL, &full);
+    Lexed recent = LexWith(source.Path(), BACKEND_STREAM, CHUNK_SIZE, &window);
+    CHECK(all == recent);
+    CHECK(window < full);
+}